@@ -23,6 +23,8 @@ public class ColorizedFolders : ModuleRules
 			"Projects", 
 			"SettingsEditor",
 			"AssetTools",
+			"AssetRegistry",
+			"DirectoryWatcher",
 			"ToolWidgets",
 		});
 	}
@@ -1,14 +1,27 @@
 ﻿// Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "ColorizedFoldersSettings.h"
+#include "ColorizedFoldersStats.h"
+#include "ColorizedFoldersTrace.h"
 #include "ColorizedFoldersUtils.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/Async.h"
 #include "ContentBrowserDataSubsystem.h"
 #include "ContentBrowserItemData.h"
 #include "IContentBrowserDataModule.h"
 #include "ISettingsModule.h"
 #include "Customization/ColorizedFoldersDetailCustomization.h"
+#include "Folders/ColorizedFoldersIndex.h"
+#include "Folders/ColorizedFoldersIndexCache.h"
+#include "Folders/ColorizedFoldersMountTable.h"
+#include "Folders/ColorizedFoldersScanner.h"
+#include "Folders/ColorizedFoldersUpdateHistory.h"
+#include "Folders/ColorizedFoldersUpdateScheduler.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
 #include "Interfaces/IPluginManager.h"
 #include "Modules/ModuleManager.h"
+#include "Tasks/Task.h"
 #include "Themes/ColorizedFoldersManager.h"
 
 #define LOCTEXT_NAMESPACE "ColorizedFolders"
@@ -29,13 +42,115 @@ private:
 	void StartColorizingFolders();
 	void RequestFolderColorUpdate();
 
+	/** Restores the folder index and the colors we applied from the previous session, if they have been cached. */
+	void LoadIndexCache();
+
+	/**
+	 * Installs the folder index precomputed by the ColorizedFolders commandlet and applies its colors, if it has been
+	 * computed for the current schemes and our own cache hasn't been built on top of this very file already. Returns false if it can't be used.
+	 */
+	bool LoadPrecomputedFolderIndex();
+
+	/** Writes the folder index of the last full update to disk, along with the colors we currently applied. */
+	void SaveIndexCache();
+
+	/** Installs the result of a background scan as the new folder index and applies its colors. */
+	void ApplyScanResult(UE::ColorizedFolders::FColorizedFoldersScanResult&& ScanResult, double ScanSeconds);
+
+	/** Re-evaluates the colors of all folders that have been marked dirty in the folder index, and records what it did. */
+	void UpdateDirtyFolders(UE::ColorizedFolders::FColorizedFoldersUpdateRecord& OutRecord);
+
+	/** Applies a folder change to the index, and remembers it if a scan is running, so it can be replayed on top of the scan. */
+	void ApplyFolderDelta(UE::ColorizedFolders::FColorizedFoldersDelta&& Delta);
+
+	/** Collects the package paths of all folders below a folder, from the same source the scan uses. */
+	void GatherSubFolders(const FString& InPackagePath, TArray<FString>& OutSubFolders) const;
+
+	/** Applies all folder changes and update requests the scheduler has collected since its last flush. */
+	void OnFlushPendingUpdate(UE::ColorizedFolders::FColorizedFoldersPendingUpdate&& PendingUpdate);
+
 	void OnItemDataUpdated(TArrayView<const FContentBrowserItemDataUpdate> DataUpdates);
+
+	/** Keeps the index in sync with the paths cached by the Asset Registry. */
+	void OnAssetRegistryPathsChanged(TConstArrayView<FStringView> Paths, UE::ColorizedFolders::EColorizedFoldersChange Change);
+	void OnAssetRegistryFilesLoaded();
+
+	/** Returns true if folders are collected from the Asset Registry rather than from disk. */
+	static bool UsesAssetRegistry();
+
+	/** Returns true if folders are collected from the Asset Registry and its initial discovery is still running. */
+	static bool IsWaitingForAssetRegistry();
+
+	/** Returns true if the folder index, or the running scan, has been matched with the published schemes. */
+	bool IsMatchedWithCurrentSchemes() const
+	{
+		return MatchedSnapshot == UColorizedFoldersManager::GetSchemeSnapshot();
+	}
 	void OnRequestUpdate(const FGuid& Id);
+
+	/** ColorizedFolders.Stats [Count]: Prints the timings of the most recent updates. */
+	void DumpUpdateStats(const TArray<FString>& Args, FOutputDevice& Ar) const;
+
+	/** ColorizedFolders.Rescan: Rebuilds the folder index from scratch, ignoring the cached folders. */
+	void ForceRescan();
+
+	/** ColorizedFolders.Dump [PathPrefix]: Prints the scheme every indexed folder resolved to, either matched itself or inherited. */
+	void DumpFolderSchemes(const TArray<FString>& Args, FOutputDevice& Ar) const;
+
+	/** All known content folders. Kept up to date by Content Browser deltas between full rescans. */
+	UE::ColorizedFolders::FColorizedFoldersIndex FolderIndex;
+
+	/** All content roots we colorize, used to convert between physical, package and Content Browser paths. */
+	UE::ColorizedFolders::FColorizedFoldersMountTable MountTable;
+
+	/** Collects folders from disk and decides which folders are excluded from colorization. */
+	UE::ColorizedFolders::FColorizedFoldersDirScanner DirScanner;
+
+	/** The colors we applied to folders so far, so updates only need to write the difference. */
+	UE::ColorizedFolders::FColorizedFoldersAppliedColors AppliedColors;
+
+	/** Whether the next update has to re-evaluate every folder, including the explicit paths outside of the index. */
+	bool bFullUpdatePending = false;
+
+	/** Generation of the latest scan request. Shared with background scans, so they notice when they have been superseded. */
+	TSharedRef<std::atomic<uint32>, ESPMode::ThreadSafe> ScanGeneration = MakeShared<std::atomic<uint32>, ESPMode::ThreadSafe>(0);
+
+	/** Whether a background scan is running, whose result hasn't been applied yet. */
+	bool bScanInFlight = false;
+
+	/**
+	 * Schemes the folder index, or the running scan, has been matched with. Applying the same theme again publishes the same
+	 * snapshot, e.g. while the themes are loaded on startup, which doesn't require matching any folder again.
+	 */
+	UE::ColorizedFolders::FColorizedFoldersSchemeSnapshotPtr MatchedSnapshot;
+
+	/** Folder changes reported while the current scan is running. */
+	TArray<UE::ColorizedFolders::FColorizedFoldersDelta> DeltasDuringScan;
+
+	/** Modification time of the precomputed folder index our own cache is built on top of, FDateTime::MinValue() if none. */
+	FDateTime PrecomputedIndexTimestamp = FDateTime::MinValue();
+
+	/** Folder index of the last full update, also read by the running scan. */
+	TSharedPtr<const UE::ColorizedFolders::FColorizedFoldersIndexCache, ESPMode::ThreadSafe> IndexCache;
+
+	/** Coalesces bursts of folder changes and update requests into a single update. */
+	UE::ColorizedFolders::FColorizedFoldersUpdateScheduler UpdateScheduler;
+
+	/** Timings of the most recent updates, for ColorizedFolders.Stats. */
+	UE::ColorizedFolders::FColorizedFoldersUpdateHistory UpdateHistory;
+
+	TArray<IConsoleObject*> ConsoleCommands;
 };
 IMPLEMENT_MODULE(FColorizedFoldersModule, ColorizedFolders)
 
 void FColorizedFoldersModule::StartupModule()
 {
+	// Commandlets resolve folder colors on their own, without any of the editor UI
+	if (IsRunningCommandlet())
+	{
+		return;
+	}
+
 	ISettingsModule& SettingsModule = FModuleManager::LoadModuleChecked<ISettingsModule>("Settings");
 	SettingsModule.RegisterSettings("Editor", "General", "Colorized Folders",
 		LOCTEXT("ColorizedFoldersSettingsName", "Colorized Folders"),
@@ -44,15 +159,45 @@ void FColorizedFoldersModule::StartupModule()
 	);
 
 	FCoreDelegates::OnPostEngineInit.AddRaw(this, &FThisModule::OnPostEngineInit);
+
+	IConsoleManager& ConsoleManager = IConsoleManager::Get();
+	ConsoleCommands.Add(ConsoleManager.RegisterConsoleCommand(TEXT("ColorizedFolders.Stats"),
+		TEXT("Prints the timings of the most recent folder color updates. Usage: ColorizedFolders.Stats [Count]"),
+		FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateRaw(this, &FThisModule::DumpUpdateStats)));
+	ConsoleCommands.Add(ConsoleManager.RegisterConsoleCommand(TEXT("ColorizedFolders.Rescan"),
+		TEXT("Rebuilds the folder index from scratch and colors all folders again."),
+		FConsoleCommandDelegate::CreateRaw(this, &FThisModule::ForceRescan)));
+	ConsoleCommands.Add(ConsoleManager.RegisterConsoleCommand(TEXT("ColorizedFolders.Dump"),
+		TEXT("Prints the scheme every folder resolved to. Usage: ColorizedFolders.Dump [PathPrefix]"),
+		FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateRaw(this, &FThisModule::DumpFolderSchemes)));
 }
 
 void FColorizedFoldersModule::ShutdownModule()
 {
-	ISettingsModule& SettingsModule = FModuleManager::GetModuleChecked<ISettingsModule>("Settings");
-	SettingsModule.UnregisterSettings("Editor", "General", "Colorized Folders");
+	if (ISettingsModule* SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings"))
+	{
+		SettingsModule->UnregisterSettings("Editor", "General", "Colorized Folders");
+	}
 
 	FCoreDelegates::OnPostEngineInit.RemoveAll(this);
 
+	for (IConsoleObject* ConsoleCommand : ConsoleCommands)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(ConsoleCommand);
+	}
+	ConsoleCommands.Empty();
+
+	// Make sure running scans and pending updates don't call back into us
+	++(*ScanGeneration);
+	UpdateScheduler.Reset();
+
+	SaveIndexCache();
+
+#if ALLOW_THEMES
+	UColorizedFoldersManager::Get().StopWatchingThemeDirectories();
+	UColorizedFoldersManager::Get().FlushPendingSaveConfig();
+#endif
+
 	if (const IContentBrowserDataModule* ContentBrowser = IContentBrowserDataModule::GetPtr())
 	{
 		if (UContentBrowserDataSubsystem* ContentBrowserSub = ContentBrowser->GetSubsystem())
@@ -60,6 +205,13 @@ void FColorizedFoldersModule::ShutdownModule()
 			ContentBrowserSub->OnItemDataUpdated().RemoveAll(this);
 		}
 	}
+
+	if (IAssetRegistry* AssetRegistry = IAssetRegistry::Get())
+	{
+		AssetRegistry->OnPathsAdded().RemoveAll(this);
+		AssetRegistry->OnPathsRemoved().RemoveAll(this);
+		AssetRegistry->OnFilesLoaded().RemoveAll(this);
+	}
 }
 
 
@@ -82,6 +234,21 @@ void FColorizedFoldersModule::OnPostEngineInit()
 
 	PropertyEditorModule.NotifyCustomizationModuleChanged();
 
+	// Folders precomputed by a build machine are colored right away. Otherwise reuse the folders of the last session,
+	// the initial update then only has to list the directories that changed since.
+	if (!LoadPrecomputedFolderIndex())
+	{
+		LoadIndexCache();
+	}
+
+	// Either way the scan below still reconciles the index with the local folders in the background, and only writes the colors that differ.
+	// A full update on the partial path tree of a running discovery would clear the colors of every folder that hasn't been found yet,
+	// so wait for the rescan once it's done. The colors of the last session, or the precomputed ones, are still applied until then.
+	if (IsWaitingForAssetRegistry())
+	{
+		return;
+	}
+
 	// Request initial update
 	RequestFolderColorUpdate();
 }
@@ -89,6 +256,7 @@ void FColorizedFoldersModule::OnPostEngineInit()
 void FColorizedFoldersModule::StartColorizingFolders()
 {
 	UColorizedFoldersManager::Get().OnThemeChanged().AddRaw(this, &FThisModule::OnRequestUpdate);
+	UpdateScheduler.SetOnFlush(UE::ColorizedFolders::FColorizedFoldersUpdateScheduler::FOnFlush::CreateRaw(this, &FThisModule::OnFlushPendingUpdate));
 
 	// Assign a delegate that triggers whenever a new item is added to the content browser.
 	// I honestly don't know if this is the right way to do it, but it works.
@@ -97,52 +265,259 @@ void FColorizedFoldersModule::StartColorizingFolders()
 	{
 		ContentBrowser->GetSubsystem()->OnItemDataUpdated().AddRaw(this, &FThisModule::OnItemDataUpdated);
 	}
+
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	AssetRegistry.OnPathsAdded().AddRaw(this, &FThisModule::OnAssetRegistryPathsChanged, UE::ColorizedFolders::EColorizedFoldersChange::Added);
+	AssetRegistry.OnPathsRemoved().AddRaw(this, &FThisModule::OnAssetRegistryPathsChanged, UE::ColorizedFolders::EColorizedFoldersChange::Removed);
+
+	// The cached path tree is incomplete until the initial discovery has finished, so scan again once it's done
+	if (IsWaitingForAssetRegistry())
+	{
+		AssetRegistry.OnFilesLoaded().AddRaw(this, &FThisModule::OnAssetRegistryFilesLoaded);
+	}
 }
 
 void FColorizedFoldersModule::RequestFolderColorUpdate()
 {
 	using namespace UE::ColorizedFolders;
-	
-	IFileManager& FileManager = IFileManager::Get();
-	IPluginManager& PluginManager = IPluginManager::Get();
-	const UColorizedFoldersManager& ThemeManager = UColorizedFoldersManager::Get();
 
-	TArray<FString> Dirs;
-	FColorizedFoldersDirIterator DirIterator(Dirs);
+	COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::RequestFolderColorUpdate");
 
-	// Scan the game content directory
-	DirIterator.SetRootName(TEXT("Game"));
-	FileManager.IterateDirectoryRecursively(*FPaths::ProjectContentDir(), DirIterator);
+	// Supersede any scan that is still running
+	const uint32 Generation = ++(*ScanGeneration);
+	bScanInFlight = true;
+	DeltasDuringScan.Reset();
+	MatchedSnapshot = UColorizedFoldersManager::GetSchemeSnapshot();
 
-	// Scan the plugin content directories
-	TArray<TSharedRef<IPlugin>> DiscoveredPlugins = PluginManager.GetDiscoveredPlugins();
-	for (TSharedRef Plugin : DiscoveredPlugins)
+	// Gather everything the scan needs on the game thread, the worker only operates on its own copies
 	{
-		if (ShouldIterateThroughPlugin(Plugin))
+		COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::BuildMountTable");
+		MountTable.Build();
+	}
+	DirScanner.SetBlacklist(UColorizedFoldersSettings::Get()->FolderBlacklist);
+
+	// The Asset Registry is thread safe and outlives this module
+	const IAssetRegistry* AssetRegistry = UsesAssetRegistry() ? IAssetRegistry::Get() : nullptr;
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION,
+		[this, Generation, LatestGeneration = ScanGeneration, Scanner = DirScanner, Mounts = MountTable, Snapshot = MatchedSnapshot.ToSharedRef(), AssetRegistry, Cache = IndexCache]()
 		{
-			// Update virtual-path so we can remove it
-			DirIterator.SetVirtualPath(Plugin->GetDescriptor().EditorCustomVirtualPath);
-			DirIterator.SetRootName(Plugin->GetName());
-			
-			FileManager.IterateDirectoryRecursively(*Plugin->GetContentDir(), DirIterator);
+			COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::ScanTask");
+
+			auto IsCancelled = [&LatestGeneration, Generation]()
+			{
+				return LatestGeneration->load(std::memory_order_relaxed) != Generation;
+			};
+
+			// The snapshot stays the same for the whole scan, even if the theme changes in the meantime
+			auto MatchFolder = [&Matcher = Snapshot->Matcher, &Mounts](const FString& Dir, const FColorizedFoldersPathState* ParentState, FColorizedFoldersPathState& OutState)
+			{
+				return MatchDir(Dir, Matcher, Mounts, ParentState, &OutState);
+			};
+
+			// Collect the game and plugin content folders, resolving the winning scheme of every folder in the same pass
+			const double ScanStartTime = FPlatformTime::Seconds();
+			FColorizedFoldersScanResult ScanResult;
+			const bool bCompleted = AssetRegistry
+				? Scanner.Scan(*AssetRegistry, Mounts.GetMountPoints(), MatchFolder, IsCancelled, ScanResult)
+				: Scanner.Scan(Mounts.GetMountPoints(), Cache.Get(), MatchFolder, IsCancelled, ScanResult);
+
+			if (!bCompleted)
+			{
+				return;
+			}
+
+			TRACE_COUNTER_SET(ColorizedFolders_ScannedFolders, ScanResult.Dirs.Num());
+			TRACE_COUNTER_SET(ColorizedFolders_PrunedFolders, ScanResult.NumPruned);
+			TRACE_BOOKMARK(TEXT("ColorizedFolders: Scanned %d folders in %d mount points, pruned %d"), ScanResult.Dirs.Num(), ScanResult.Roots.Num(), ScanResult.NumPruned);
+
+			// Only applying the colors has to happen on the game thread
+			AsyncTask(ENamedThreads::GameThread, [this, Generation, LatestGeneration, ScanResult = MoveTemp(ScanResult), ScanSeconds = FPlatformTime::Seconds() - ScanStartTime]() mutable
+			{
+				// Checked on the game thread, so the module can't have been shut down in the meantime
+				if (LatestGeneration->load() == Generation)
+				{
+					ApplyScanResult(MoveTemp(ScanResult), ScanSeconds);
+				}
+			});
+		},
+		UE::Tasks::ETaskPriority::BackgroundNormal);
+}
+
+void FColorizedFoldersModule::ApplyScanResult(UE::ColorizedFolders::FColorizedFoldersScanResult&& ScanResult, double ScanSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ColorizedFolders_ApplyScanResult);
+	COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::ApplyScanResult");
+
+	using namespace UE::ColorizedFolders;
+
+	bScanInFlight = false;
+
+	FColorizedFoldersUpdateRecord Record;
+	Record.Kind = EColorizedFoldersUpdateKind::Scan;
+	Record.ScanSeconds = ScanSeconds;
+	Record.NumPruned = ScanResult.NumPruned;
+	Record.NumDeltas = DeltasDuringScan.Num();
+
+	// Rebuild the folder index from scratch, the scan has matched all of its folders already
+	{
+		COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::BuildIndex");
+
+		FolderIndex.Reset();
+		for (int32 DirIdx = 0; DirIdx < ScanResult.Dirs.Num(); ++DirIdx)
+		{
+			FolderIndex.SetSchemeIndex(FolderIndex.AddFolder(ScanResult.Dirs[DirIdx]), ScanResult.SchemeIndices[DirIdx]);
 		}
+		FolderIndex.ClearDirtyFolders();
+	}
+
+	// Replay the changes that happened while the scan was running
+	for (const UE::ColorizedFolders::FColorizedFoldersDelta& Delta : DeltasDuringScan)
+	{
+		FolderIndex.ApplyDelta(Delta);
 	}
+	DeltasDuringScan.Reset();
 
 	// Colorize the folders
-	TArray<FString> Tracking = Dirs;
-	for (int i = 0; i < NUM_FOLDER_SCHEMES; ++i)
+	bFullUpdatePending = true;
+	UpdateDirtyFolders(Record);
+	UpdateHistory.Add(Record);
+
+	// Remember the result for the next session
+	TSharedRef<FColorizedFoldersIndexCache, ESPMode::ThreadSafe> NewCache = MakeShared<FColorizedFoldersIndexCache, ESPMode::ThreadSafe>();
+	NewCache->Build(ScanResult, AppliedColors);
+	NewCache->SetPrecomputedTimestamp(PrecomputedIndexTimestamp);
+	IndexCache = NewCache;
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [NewCache]()
+	{
+		COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::SaveIndexCache");
+		NewCache->Save(FColorizedFoldersIndexCache::GetDefaultFilename());
+	},
+	UE::Tasks::ETaskPriority::BackgroundLow);
+}
+
+void FColorizedFoldersModule::LoadIndexCache()
+{
+	using namespace UE::ColorizedFolders;
+
+	TSharedRef<FColorizedFoldersIndexCache, ESPMode::ThreadSafe> LoadedCache = MakeShared<FColorizedFoldersIndexCache, ESPMode::ThreadSafe>();
+	if (!LoadedCache->Load(FColorizedFoldersIndexCache::GetDefaultFilename()))
 	{
-		ColorizeDirsAccordingToScheme(Dirs, ThemeManager.GetScheme(i), Tracking);
+		return;
 	}
 
-	// Clear the tracking array
-	/*if (UEditorsFavouriteSettings::Get()->bClearNotListedFolderColors)
+	// The colors are still stored in the editor config from the last session, so there is nothing to write.
+	// Only remember them, so the initial update skips every folder whose color didn't change.
+	for (const FColorizedFoldersCachedDir& CachedDir : LoadedCache->GetDirs())
 	{
-		for (const FString& Dir : Tracking)
+		if (CachedDir.bIsRoot)
 		{
-			AssetViewUtils::SetPathColor(Dir, TOptional<FLinearColor>());
-		}	
-	}*/
+			continue;
+		}
+
+		FolderIndex.AddFolder(CachedDir.Path);
+		if (CachedDir.Color.IsSet())
+		{
+			AppliedColors.SeedColor(CachedDir.Path, CachedDir.Color.GetValue());
+		}
+	}
+	FolderIndex.ClearDirtyFolders();
+
+	// The colors of the last session stand until the first scan, re-applying the same theme in the meantime doesn't change them
+	MatchedSnapshot = UColorizedFoldersManager::GetSchemeSnapshot();
+	PrecomputedIndexTimestamp = LoadedCache->GetPrecomputedTimestamp();
+	IndexCache = LoadedCache;
+}
+
+bool FColorizedFoldersModule::LoadPrecomputedFolderIndex()
+{
+	using namespace UE::ColorizedFolders;
+
+	const FString Filename = UColorizedFoldersSettings::Get()->GetPrecomputedFolderIndexFilename();
+	const FDateTime PrecomputedTime = IFileManager::Get().GetTimeStamp(*Filename);
+	if (PrecomputedTime == FDateTime::MinValue())
+	{
+		return false;
+	}
+
+	// Our own cache is rewritten after every scan and on shutdown, so compare with the precomputed index it has been built on top of
+	// rather than with its own modification time. Every precomputed index that is synced is used once, no matter how recent our cache is.
+	FColorizedFoldersIndexCache LocalCache;
+	const bool bHasLocalCache = LocalCache.Load(FColorizedFoldersIndexCache::GetDefaultFilename());
+	if (bHasLocalCache && LocalCache.GetPrecomputedTimestamp() == PrecomputedTime)
+	{
+		return false;
+	}
+
+	TSharedRef<FColorizedFoldersIndexCache, ESPMode::ThreadSafe> Precomputed = MakeShared<FColorizedFoldersIndexCache, ESPMode::ThreadSafe>();
+	if (!Precomputed->Load(Filename))
+	{
+		return false;
+	}
+
+	// The scheme indices are only valid for the schemes they have been resolved with
+	const FColorizedFoldersSchemeSnapshotRef Snapshot = UColorizedFoldersManager::GetSchemeSnapshot();
+	if (!Precomputed->HasSchemes(UColorizedFoldersManager::GetCurrentThemeId(), Snapshot->GetSchemesHash()))
+	{
+		return false;
+	}
+
+	// Set up what coloring and live updates need, the reconciling scan only gets to it later
+	MountTable.Build();
+	DirScanner.SetBlacklist(UColorizedFoldersSettings::Get()->FolderBlacklist);
+
+	// The colors of the last session are still stored in the editor config. Remember them the same way LoadIndexCache() does,
+	// so the update only writes the colors that differ from the precomputed ones and clears the ones that aren't used anymore.
+	if (bHasLocalCache)
+	{
+		for (const FColorizedFoldersCachedDir& CachedDir : LocalCache.GetDirs())
+		{
+			if (!CachedDir.bIsRoot && CachedDir.Color.IsSet())
+			{
+				AppliedColors.SeedColor(CachedDir.Path, CachedDir.Color.GetValue());
+			}
+		}
+	}
+
+	FolderIndex.Reset();
+	for (const FColorizedFoldersCachedDir& CachedDir : Precomputed->GetDirs())
+	{
+		if (!CachedDir.bIsRoot && !DirScanner.IsExcluded(CachedDir.Path))
+		{
+			FolderIndex.SetSchemeIndex(FolderIndex.AddFolder(CachedDir.Path), Snapshot->Schemes.IsValidIndex(CachedDir.SchemeIndex) ? CachedDir.SchemeIndex : INDEX_NONE);
+		}
+	}
+	FolderIndex.ClearDirtyFolders();
+
+	FColorizedFoldersUpdateRecord Record;
+	bFullUpdatePending = true;
+	UpdateDirtyFolders(Record);
+	UpdateHistory.Add(Record);
+
+	// Disk scans can still skip the directories that haven't changed since
+	PrecomputedIndexTimestamp = PrecomputedTime;
+	IndexCache = Precomputed;
+	return true;
+}
+
+void FColorizedFoldersModule::SaveIndexCache()
+{
+	using namespace UE::ColorizedFolders;
+
+	if (!IndexCache.IsValid())
+	{
+		return;
+	}
+
+	// Colors may have been changed by deltas since the last full update. Running scans may still read the shared cache, so update a copy.
+	FColorizedFoldersIndexCache CacheToSave = *IndexCache;
+	CacheToSave.UpdateColors(AppliedColors);
+
+	// The scheme indices of a precomputed index aren't kept up to date, so they must not be used again
+	CacheToSave.SetSchemes(FGuid(), 0);
+	CacheToSave.SetPrecomputedTimestamp(PrecomputedIndexTimestamp);
+	CacheToSave.Save(FColorizedFoldersIndexCache::GetDefaultFilename());
 }
 
 void FColorizedFoldersModule::OnItemDataUpdated(TArrayView<const FContentBrowserItemDataUpdate> DataUpdates)
@@ -154,15 +529,238 @@ void FColorizedFoldersModule::OnItemDataUpdated(TArrayView<const FContentBrowser
 		return;
 	}
 
-	// Request a folder update if any of the items are folders
-	for (const auto& Data : DataUpdates)
+	using namespace UE::ColorizedFolders;
+
+	UContentBrowserDataSubsystem* ContentBrowserData = IContentBrowserDataModule::Get().GetSubsystem();
+
+	// Queue the folder deltas for the index, so only the affected folders have to be re-evaluated once the burst is over
+	for (const FContentBrowserItemDataUpdate& Data : DataUpdates)
 	{
-		if (Data.GetItemData().IsFolder())
+		const FContentBrowserItemData& ItemData = Data.GetItemData();
+		if (!ItemData.IsFolder())
 		{
-			RequestFolderColorUpdate();
-			return;
+			continue;
 		}
+
+		// Purely virtual folders (e.g. "/All/Plugins") don't map to any content folder
+		const FName InternalPath = ItemData.GetInternalPath();
+		if (InternalPath.IsNone())
+		{
+			continue;
+		}
+
+		FColorizedFoldersDelta Delta;
+		Delta.Path = InternalPath.ToString();
+		const bool bExcluded = DirScanner.IsExcluded(Delta.Path);
+
+		switch (Data.GetUpdateType())
+		{
+		case EContentBrowserItemUpdateType::Added:
+			Delta.Change = EColorizedFoldersChange::Added;
+			break;
+
+		case EContentBrowserItemUpdateType::Modified:
+			Delta.Change = EColorizedFoldersChange::Modified;
+			break;
+
+		case EContentBrowserItemUpdateType::Moved:
+			if (ContentBrowserData->TryConvertVirtualPath(FNameBuilder(Data.GetPreviousVirtualPath()), Delta.PreviousPath) == EContentBrowserPathType::Internal)
+			{
+				if (bExcluded)
+				{
+					// Moved into an excluded folder, so forget about the whole subtree
+					Delta.Change = EColorizedFoldersChange::Removed;
+					Delta.Path = MoveTemp(Delta.PreviousPath);
+				}
+				else
+				{
+					Delta.Change = EColorizedFoldersChange::Moved;
+				}
+			}
+			else
+			{
+				Delta.Change = EColorizedFoldersChange::Added;
+			}
+			break;
+
+		case EContentBrowserItemUpdateType::Removed:
+			Delta.Change = EColorizedFoldersChange::Removed;
+			break;
+
+		default:
+			continue;
+		}
+
+		if (bExcluded && Delta.Change == EColorizedFoldersChange::Added)
+		{
+			continue;
+		}
+
+		UpdateScheduler.AddDelta(MoveTemp(Delta));
+	}
+}
+
+void FColorizedFoldersModule::OnAssetRegistryPathsChanged(TConstArrayView<FStringView> Paths, UE::ColorizedFolders::EColorizedFoldersChange Change)
+{
+	// Paths discovered during the initial load are picked up by the rescan once it's done
+	if (!UsesAssetRegistry() || !UColorizedFoldersSettings::Get()->IsLiveUpdateFoldersEnabled() || IAssetRegistry::GetChecked().IsLoadingAssets())
+	{
+		return;
+	}
+
+	using namespace UE::ColorizedFolders;
+
+	for (const FStringView Path : Paths)
+	{
+		// Only folders below a mounted content root are colored
+		if (MountTable.FindByPackagePath(Path) == nullptr || DirScanner.IsExcluded(Path))
+		{
+			continue;
+		}
+
+		FColorizedFoldersDelta Delta;
+		Delta.Change = Change;
+		Delta.Path = FString(Path);
+		UpdateScheduler.AddDelta(MoveTemp(Delta));
+	}
+}
+
+void FColorizedFoldersModule::OnAssetRegistryFilesLoaded()
+{
+	IAssetRegistry::GetChecked().OnFilesLoaded().RemoveAll(this);
+	UpdateScheduler.RequestRescan();
+}
+
+bool FColorizedFoldersModule::UsesAssetRegistry()
+{
+	return UColorizedFoldersSettings::Get()->ScanSource == EColorizedFoldersScanSource::AssetRegistry;
+}
+
+bool FColorizedFoldersModule::IsWaitingForAssetRegistry()
+{
+	return UsesAssetRegistry() && IAssetRegistry::GetChecked().IsLoadingAssets();
+}
+
+void FColorizedFoldersModule::ApplyFolderDelta(UE::ColorizedFolders::FColorizedFoldersDelta&& Delta)
+{
+	using namespace UE::ColorizedFolders;
+
+	// A folder moved out of a folder we don't track, e.g. an excluded one, brings along a subtree the index has never seen
+	if (Delta.Change == EColorizedFoldersChange::Moved && !FolderIndex.ContainsNode(Delta.PreviousPath))
+	{
+		TArray<FString> SubFolders;
+		GatherSubFolders(Delta.Path, SubFolders);
+		for (FString& SubFolder : SubFolders)
+		{
+			if (!DirScanner.IsExcluded(SubFolder))
+			{
+				FColorizedFoldersDelta SubFolderDelta;
+				SubFolderDelta.Change = EColorizedFoldersChange::Added;
+				SubFolderDelta.Path = MoveTemp(SubFolder);
+				ApplyFolderDelta(MoveTemp(SubFolderDelta));
+			}
+		}
+	}
+
+	FolderIndex.ApplyDelta(Delta);
+
+	// The scan result will replace the index, so these changes have to be applied to it again
+	if (bScanInFlight)
+	{
+		DeltasDuringScan.Add(MoveTemp(Delta));
+	}
+}
+
+void FColorizedFoldersModule::GatherSubFolders(const FString& InPackagePath, TArray<FString>& OutSubFolders) const
+{
+	if (UsesAssetRegistry())
+	{
+		IAssetRegistry::GetChecked().GetSubPaths(InPackagePath, OutSubFolders, true);
+		return;
+	}
+
+	const UE::ColorizedFolders::FColorizedFoldersMountPoint* MountPoint = MountTable.FindByPackagePath(InPackagePath);
+	if (MountPoint == nullptr)
+	{
+		return;
+	}
+
+	FString PhysicalDir = MountPoint->ContentDir;
+	PhysicalDir += FStringView(InPackagePath).RightChop(MountPoint->PackageRoot.Len());
+	IFileManager::Get().IterateDirectoryRecursively(*PhysicalDir, [MountPoint, &OutSubFolders](const TCHAR* Filename, bool bIsDirectory)
+	{
+		if (bIsDirectory)
+		{
+			TStringBuilder<512> PackagePath;
+			UE::ColorizedFolders::FColorizedFoldersMountTable::AppendPackagePath(*MountPoint, Filename, PackagePath);
+			OutSubFolders.Emplace(PackagePath.ToView());
+		}
+		return true;
+	});
+}
+
+void FColorizedFoldersModule::UpdateDirtyFolders(UE::ColorizedFolders::FColorizedFoldersUpdateRecord& OutRecord)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ColorizedFolders_UpdateDirtyFolders);
+	COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::UpdateDirtyFolders");
+
+	using namespace UE::ColorizedFolders;
+
+	const double StartTime = FPlatformTime::Seconds();
+	const uint64 NumWritesBefore = AppliedColors.GetNumWrites();
+
+	// Hold on to the snapshot, so the schemes and their lookup can't change halfway through the update
+	const FColorizedFoldersSchemeSnapshotRef Snapshot = UColorizedFoldersManager::GetSchemeSnapshot();
+	const TConstArrayView<FColorizedFolderColorScheme> Schemes = Snapshot->Schemes;
+	const FColorizedFoldersSchemeMatcher& Matcher = Snapshot->Matcher;
+
+	// The result of a running scan replaces the index, along with the schemes it has been matched with
+	if (!bScanInFlight)
+	{
+		MatchedSnapshot = Snapshot;
+	}
+
+	const bool bFullUpdate = bFullUpdatePending;
+	bFullUpdatePending = false;
+
+	// Collect all color changes, so the config section is written and the Content Browser refreshed only once per update
+	AppliedColors.BeginWriteBatch();
+	if (bFullUpdate)
+	{
+		AppliedColors.BeginFullUpdate();
+	}
+
+	// Folders that were removed or moved away shouldn't keep their color
+	TArray<FString> RemovedDirs;
+	FolderIndex.ConsumeRemovedFolders(RemovedDirs);
+	for (const FString& Dir : RemovedDirs)
+	{
+		AppliedColors.ClearColor(Dir);
+	}
+
+	// Resolve the winning scheme of every dirty folder, and carry inherited schemes down to the subfolders
+	ColorizeIndexedFolders(FolderIndex, bFullUpdate, Schemes, Matcher, MountTable, AppliedColors);
+
+	if (bFullUpdate)
+	{
+		ColorizeUnindexedExplicitPaths(FolderIndex, Schemes, Matcher, MountTable, AppliedColors);
+
+		// Clear every color we applied before that isn't part of the theme anymore
+		AppliedColors.EndFullUpdate();
+	}
+	AppliedColors.EndWriteBatch();
+
+	OutRecord.Time = FDateTime::Now();
+	if (OutRecord.Kind != EColorizedFoldersUpdateKind::Scan)
+	{
+		OutRecord.Kind = bFullUpdate ? EColorizedFoldersUpdateKind::Full : EColorizedFoldersUpdateKind::Incremental;
 	}
+	OutRecord.ApplySeconds = FPlatformTime::Seconds() - StartTime;
+	OutRecord.NumFolders = FolderIndex.Num();
+	OutRecord.NumWrites = AppliedColors.GetNumWrites() - NumWritesBefore;
+
+	TRACE_COUNTER_SET(ColorizedFolders_IndexedFolders, OutRecord.NumFolders);
+	TRACE_COUNTER_SET(ColorizedFolders_ColorWrites, static_cast<int64>(OutRecord.NumWrites));
 }
 
 void FColorizedFoldersModule::OnRequestUpdate(const FGuid& Id)
@@ -173,8 +771,164 @@ void FColorizedFoldersModule::OnRequestUpdate(const FGuid& Id)
 	{
 		return;
 	}
-	
-	RequestFolderColorUpdate();
+
+	// Nothing to do if the same theme has just been applied again
+	if (IsMatchedWithCurrentSchemes())
+	{
+		return;
+	}
+
+	// The folders themselves didn't change, so there is no need to rescan the disk
+	UpdateScheduler.RequestRematchAll();
+}
+
+void FColorizedFoldersModule::OnFlushPendingUpdate(UE::ColorizedFolders::FColorizedFoldersPendingUpdate&& PendingUpdate)
+{
+	// The request may be older than the scan that has been started since, or the theme may have been switched back
+	if (PendingUpdate.bRematchAll && IsMatchedWithCurrentSchemes())
+	{
+		PendingUpdate.bRematchAll = false;
+		if (!PendingUpdate.bRescan && PendingUpdate.Deltas.IsEmpty())
+		{
+			return;
+		}
+	}
+
+	// A running scan has matched its folders against the previous schemes, so start over
+	if (PendingUpdate.bRescan || (PendingUpdate.bRematchAll && bScanInFlight))
+	{
+		// Start the scan first, so the deltas are replayed on top of its result
+		RequestFolderColorUpdate();
+		for (UE::ColorizedFolders::FColorizedFoldersDelta& Delta : PendingUpdate.Deltas)
+		{
+			ApplyFolderDelta(MoveTemp(Delta));
+		}
+		return;
+	}
+
+	for (UE::ColorizedFolders::FColorizedFoldersDelta& Delta : PendingUpdate.Deltas)
+	{
+		ApplyFolderDelta(MoveTemp(Delta));
+	}
+
+	if (PendingUpdate.bRematchAll)
+	{
+		FolderIndex.MarkAllDirty();
+		bFullUpdatePending = true;
+	}
+
+	UE::ColorizedFolders::FColorizedFoldersUpdateRecord Record;
+	Record.NumDeltas = PendingUpdate.Deltas.Num();
+	UpdateDirtyFolders(Record);
+	UpdateHistory.Add(Record);
+}
+
+void FColorizedFoldersModule::DumpUpdateStats(const TArray<FString>& Args, FOutputDevice& Ar) const
+{
+	using namespace UE::ColorizedFolders;
+
+	const TConstArrayView<FColorizedFoldersUpdateRecord> Records = UpdateHistory.GetRecords();
+	const int32 NumRecords = FMath::Min(Args.IsEmpty() ? 10 : FMath::Max(FCString::Atoi(*Args[0]), 1), Records.Num());
+
+	auto GetKindName = [](EColorizedFoldersUpdateKind Kind)
+	{
+		switch (Kind)
+		{
+		case EColorizedFoldersUpdateKind::Scan:
+			return TEXT("Scan");
+		case EColorizedFoldersUpdateKind::Full:
+			return TEXT("Full");
+		default:
+			return TEXT("Incremental");
+		}
+	};
+
+	Ar.Logf(TEXT("Last %d of %d folder color updates:"), NumRecords, Records.Num());
+	Ar.Logf(TEXT("%-12s %-11s %10s %10s %8s %8s %8s %8s"), TEXT("Time"), TEXT("Kind"), TEXT("Scan ms"), TEXT("Apply ms"), TEXT("Folders"), TEXT("Pruned"), TEXT("Deltas"), TEXT("Writes"));
+	for (const FColorizedFoldersUpdateRecord& Record : Records.Slice(Records.Num() - NumRecords, NumRecords))
+	{
+		Ar.Logf(TEXT("%-12s %-11s %10.2f %10.2f %8d %8d %8d %8llu"), *Record.Time.ToString(TEXT("%H:%M:%S.%s")), GetKindName(Record.Kind),
+			Record.ScanSeconds * 1000.0, Record.ApplySeconds * 1000.0, Record.NumFolders, Record.NumPruned, Record.NumDeltas, Record.NumWrites);
+	}
+
+	if (bScanInFlight)
+	{
+		Ar.Log(TEXT("A scan is running."));
+	}
+}
+
+void FColorizedFoldersModule::ForceRescan()
+{
+	// Without the cached folders, the disk scan has to list every directory again
+	IndexCache.Reset();
+	UpdateScheduler.RequestRescan();
+	UpdateScheduler.Flush();
+}
+
+void FColorizedFoldersModule::DumpFolderSchemes(const TArray<FString>& Args, FOutputDevice& Ar) const
+{
+	using namespace UE::ColorizedFolders;
+
+	const FColorizedFoldersSchemeSnapshotRef Snapshot = UColorizedFoldersManager::GetSchemeSnapshot();
+	const TConstArrayView<FColorizedFolderColorScheme> Schemes = Snapshot->Schemes;
+	const FStringView PathPrefix = Args.IsEmpty() ? FStringView() : FStringView(Args[0]);
+
+	auto DescribeScheme = [](int32 SchemeIndex)
+	{
+#if ALLOW_THEMES
+		return FString::Printf(TEXT("%d '%s'"), SchemeIndex, *UColorizedFoldersManager::Get().GetSchemeDisplayName(SchemeIndex).ToString());
+#else
+		return FString::FromInt(SchemeIndex);
+#endif
+	};
+
+	// Only folders that resolved to a scheme, everything else keeps its default color
+	TArray<TPair<FString, FString>> Assignments;
+	for (int32 NodeIndex = 0; NodeIndex < FolderIndex.GetMaxNodeIndex(); ++NodeIndex)
+	{
+		if (!FolderIndex.IsValidNode(NodeIndex))
+		{
+			continue;
+		}
+
+		const FColorizedFoldersIndex::FNode& Node = FolderIndex.GetNode(NodeIndex);
+		if (!Node.bExplicit || !FStringView(Node.Path).StartsWith(PathPrefix, ESearchCase::IgnoreCase))
+		{
+			continue;
+		}
+
+		FString Description;
+		if (Node.SchemeIndex != INDEX_NONE)
+		{
+			Description = DescribeScheme(Node.SchemeIndex);
+		}
+		else
+		{
+			const FColorizedFoldersInheritedScheme Inherited = FindInheritedScheme(FolderIndex, NodeIndex, Schemes);
+			if (Inherited.SchemeIndex == INDEX_NONE)
+			{
+				continue;
+			}
+			Description = FString::Printf(TEXT("%s, inherited from %d level(s) up"), *DescribeScheme(Inherited.SchemeIndex), Inherited.Distance);
+		}
+
+		if (const FLinearColor* AppliedColor = AppliedColors.FindColor(Node.Path))
+		{
+			Description += FString::Printf(TEXT(", applied #%s"), *AppliedColor->ToFColor(true).ToHex());
+		}
+		Assignments.Emplace(Node.Path, MoveTemp(Description));
+	}
+
+	Assignments.Sort([](const TPair<FString, FString>& A, const TPair<FString, FString>& B)
+	{
+		return A.Key < B.Key;
+	});
+
+	Ar.Logf(TEXT("%d of %d indexed folders resolved to a scheme:"), Assignments.Num(), FolderIndex.Num());
+	for (const TPair<FString, FString>& Assignment : Assignments)
+	{
+		Ar.Logf(TEXT("  %s: scheme %s"), *Assignment.Key, *Assignment.Value);
+	}
 }
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "ColorizedFoldersSettings.h"
 
+#include "Folders/ColorizedFoldersIndexCache.h"
 #include "Themes/ColorizedFoldersManager.h"
 
 UColorizedFoldersSettings::UColorizedFoldersSettings()
@@ -21,17 +22,23 @@ UColorizedFoldersSettings* UColorizedFoldersSettings::GetMutable()
 
 void UColorizedFoldersSettings::Init()
 {
-	if (CurrentAppliedTheme.IsValid())
-	{
-		UColorizedFoldersManager::Get().ApplyTheme(CurrentAppliedTheme);
-	}
-	else
+	if (!CurrentAppliedTheme.IsValid())
 	{
 		CurrentAppliedTheme = UColorizedFoldersManager::GetCurrentThemeId();
 		SaveConfig();
 	}
 
-	UColorizedFoldersManager::Get().ApplyTheme(UColorizedFoldersManager::Get().GetCurrentTheme().Id);
+	// Falls back to the current theme if the applied theme doesn't exist anymore
+	UColorizedFoldersManager::Get().ApplyTheme(CurrentAppliedTheme);
+}
+
+FString UColorizedFoldersSettings::GetPrecomputedFolderIndexFilename() const
+{
+	if (PrecomputedFolderIndex.FilePath.IsEmpty())
+	{
+		return UE::ColorizedFolders::FColorizedFoldersIndexCache::GetPrecomputedFilename();
+	}
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), PrecomputedFolderIndex.FilePath);
 }
 
 void UColorizedFoldersSettings::PostLoad()
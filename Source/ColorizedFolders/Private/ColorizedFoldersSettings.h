@@ -8,6 +8,17 @@
 
 #include "ColorizedFoldersSettings.generated.h"
 
+/** Where the folders to colorize are collected from. */
+UENUM()
+enum class EColorizedFoldersScanSource : uint8
+{
+	/** Use the folders the Asset Registry has cached in memory. Only mounted content paths are colored. */
+	AssetRegistry,
+
+	/** Walk the content directories on disk. */
+	Disk,
+};
+
 /** Settings for the folder color schemes. */
 UCLASS(Config=EditorPerProjectUserSettings, DefaultConfig, DisplayName="Colorized Folders Settings")
 class UColorizedFoldersSettings : public UObject
@@ -30,6 +41,9 @@ public:
 		return bLiveUpdateFolders;
 	}
 
+	/** Returns the absolute path of the precomputed folder index. */
+	FString GetPrecomputedFolderIndexFilename() const;
+
 protected:
 	//~ Begin UObject Interface
 	virtual void PostLoad() override;
@@ -54,6 +68,32 @@ public:
 	UPROPERTY(Config, EditDefaultsOnly, Category = ContentBrowser)
 	bool bLiveUpdateFolders = true;
 
+	/**
+	 * Time in seconds without further folder changes before pending changes are applied.
+	 * Bulk operations like imports or source control syncs report many changes in quick succession, which are then applied at once.
+	 */
+	UPROPERTY(Config, EditDefaultsOnly, Category = ContentBrowser, meta = (ClampMin = 0, Units = s, EditCondition = bLiveUpdateFolders))
+	float UpdateQuietPeriod = 0.1f;
+
+	/** Maximum time in seconds a folder change waits to be applied while further changes keep coming in. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = ContentBrowser, meta = (ClampMin = 0, Units = s, EditCondition = bLiveUpdateFolders))
+	float MaxUpdateDelay = 1.f;
+
+	/**
+	 * Where the folders are collected from during a full update.
+	 * The Asset Registry doesn't need any disk access, the disk scan is only meant as a fallback.
+	 */
+	UPROPERTY(Config, EditDefaultsOnly, Category = ContentBrowser)
+	EColorizedFoldersScanSource ScanSource = EColorizedFoldersScanSource::AssetRegistry;
+
+	/**
+	 * Folder colors precomputed by the ColorizedFolders commandlet, e.g. on a build machine. Relative paths are relative to the project dir.
+	 * Whenever the file changes and has been computed for the current theme, it's applied on startup instead of the folders cached by this editor.
+	 * Local folders are still reconciled by a scan in the background. Defaults to Saved/ColorizedFolders/PrecomputedFolderIndex.bin.
+	 */
+	UPROPERTY(Config, EditDefaultsOnly, Category = ContentBrowser, meta = (FilePathFilter = "bin"))
+	FFilePath PrecomputedFolderIndex;
+
 	/**
 	 * List of folders to ignore.
 	 */
@@ -0,0 +1,17 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "ColorizedFoldersStats.h"
+
+DEFINE_STAT(STAT_ColorizedFolders_Scan);
+DEFINE_STAT(STAT_ColorizedFolders_ApplyScanResult);
+DEFINE_STAT(STAT_ColorizedFolders_UpdateDirtyFolders);
+DEFINE_STAT(STAT_ColorizedFolders_LoadThemes);
+DEFINE_STAT(STAT_ColorizedFolders_ApplyTheme);
+
+DEFINE_STAT(STAT_ColorizedFolders_FoldersVisited);
+DEFINE_STAT(STAT_ColorizedFolders_FoldersPruned);
+DEFINE_STAT(STAT_ColorizedFolders_FoldersMatched);
+DEFINE_STAT(STAT_ColorizedFolders_PathColorWrites);
+DEFINE_STAT(STAT_ColorizedFolders_ThemesLoaded);
+DEFINE_STAT(STAT_ColorizedFolders_RequestsCoalesced);
@@ -0,0 +1,22 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("ColorizedFolders"), STATGROUP_ColorizedFolders, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Scan"), STAT_ColorizedFolders_Scan, STATGROUP_ColorizedFolders, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Scan Result"), STAT_ColorizedFolders_ApplyScanResult, STATGROUP_ColorizedFolders, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Dirty Folders"), STAT_ColorizedFolders_UpdateDirtyFolders, STATGROUP_ColorizedFolders, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Themes"), STAT_ColorizedFolders_LoadThemes, STATGROUP_ColorizedFolders, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Theme"), STAT_ColorizedFolders_ApplyTheme, STATGROUP_ColorizedFolders, );
+
+/** Totals since startup, they aren't reset every frame. */
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Folders Visited"), STAT_ColorizedFolders_FoldersVisited, STATGROUP_ColorizedFolders, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Folders Pruned"), STAT_ColorizedFolders_FoldersPruned, STATGROUP_ColorizedFolders, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Folders Matched"), STAT_ColorizedFolders_FoldersMatched, STATGROUP_ColorizedFolders, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Folder Color Writes"), STAT_ColorizedFolders_PathColorWrites, STATGROUP_ColorizedFolders, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Themes Loaded"), STAT_ColorizedFolders_ThemesLoaded, STATGROUP_ColorizedFolders, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Requests Coalesced"), STAT_ColorizedFolders_RequestsCoalesced, STATGROUP_ColorizedFolders, );
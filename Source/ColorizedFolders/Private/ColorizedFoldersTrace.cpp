@@ -0,0 +1,12 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "ColorizedFoldersTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(ColorizedFoldersChannel);
+
+TRACE_DECLARE_INT_COUNTER(ColorizedFolders_ScannedFolders, TEXT("ColorizedFolders/ScannedFolders"));
+TRACE_DECLARE_INT_COUNTER(ColorizedFolders_PrunedFolders, TEXT("ColorizedFolders/PrunedFolders"));
+TRACE_DECLARE_INT_COUNTER(ColorizedFolders_IndexedFolders, TEXT("ColorizedFolders/IndexedFolders"));
+TRACE_DECLARE_INT_COUNTER(ColorizedFolders_DirtyFolders, TEXT("ColorizedFolders/DirtyFolders"));
+TRACE_DECLARE_INT_COUNTER(ColorizedFolders_ColorWrites, TEXT("ColorizedFolders/ColorWrites"));
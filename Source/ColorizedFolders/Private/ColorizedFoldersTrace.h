@@ -0,0 +1,25 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "Trace/Trace.h"
+
+/** Trace channel for the phases of folder color updates. Enable it with -trace=cpu,ColorizedFolders, or "Trace.Enable ColorizedFolders". */
+UE_TRACE_CHANNEL_EXTERN(ColorizedFoldersChannel);
+
+/** Scoped timing event on the ColorizedFolders channel. */
+#define COLORIZEDFOLDERS_TRACE_SCOPE(NameStr) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(NameStr, ColorizedFoldersChannel)
+
+/** Scoped timing event whose name is built at runtime, e.g. to include the mount point. Every distinct name becomes its own timer. */
+#define COLORIZEDFOLDERS_TRACE_SCOPE_TEXT(Name) TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(Name, ColorizedFoldersChannel)
+
+/** Folder counts of the latest update, shown as counter tracks next to the timing events. */
+TRACE_DECLARE_INT_COUNTER_EXTERN(ColorizedFolders_ScannedFolders);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ColorizedFolders_PrunedFolders);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ColorizedFolders_IndexedFolders);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ColorizedFolders_DirtyFolders);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ColorizedFolders_ColorWrites);
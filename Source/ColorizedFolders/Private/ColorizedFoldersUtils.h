@@ -2,7 +2,14 @@
 
 #pragma once
 #include "AssetViewUtils.h"
+#include "Algo/AnyOf.h"
 #include "ColorizedFoldersSettings.h"
+#include "ColorizedFoldersStats.h"
+#include "ColorizedFoldersTrace.h"
+#include "Folders/ColorizedFoldersAppliedColors.h"
+#include "Folders/ColorizedFoldersIndex.h"
+#include "Folders/ColorizedFoldersMountTable.h"
+#include "Folders/ColorizedFoldersSchemeMatcher.h"
 #include "Interfaces/IPluginManager.h"
 #include "Themes/ColorizedFoldersTheme.h"
 
@@ -10,13 +17,6 @@ struct FColorizedFolderColorScheme;
 
 namespace UE::ColorizedFolders
 {
-	/** Returns whether the path is in the game dir or plugin dir */
-	inline void IsUnderGameOrPluginDir(const FString& InPath, bool& OutIsGameDir, bool& OutIsPluginDir)
-	{
-		OutIsGameDir = FPaths::IsUnderDirectory(InPath, *FPaths::ProjectContentDir());
-		OutIsPluginDir = FPaths::IsUnderDirectory(InPath, *FPaths::ProjectPluginsDir());
-	}
-
 	/** Checks if this is a valid plugin to iterate through */
 	inline bool ShouldIterateThroughPlugin(const TSharedRef<IPlugin>& Plugin)
 	{
@@ -24,123 +24,185 @@ namespace UE::ColorizedFolders
 			Plugin->CanContainContent();
 	}
 
-	/** Builds a pretty string for a folder path */
-	inline FString BuildPrettyDirPath(const FString& InPath, const FString& InRootName)
+	/**
+	 * Returns the index of the winning scheme for a folder, or INDEX_NONE. Safe to call from any thread.
+	 * Folder walks pass the path pattern state of the parent folder, and receive the state of this folder for its children.
+	 */
+	inline int32 MatchDir(const FString& Dir, const FColorizedFoldersSchemeMatcher& Matcher, const FColorizedFoldersMountTable& MountTable,
+		const FColorizedFoldersPathState* ParentState = nullptr, FColorizedFoldersPathState* OutState = nullptr)
+	{
+		// Explicit paths may be written as they're shown in the Content Browser
+		TStringBuilder<512> VirtualPath;
+		MountTable.TryConvertPackageToVirtualPath(Dir, VirtualPath);
+
+		return Matcher.Match(Dir, VirtualPath, ParentState, OutState);
+	}
+
+	/** Scheme a folder inherits from its closest matching ancestor, along with how many levels below that ancestor the folder is. */
+	struct FColorizedFoldersInheritedScheme
 	{
-		// Check if this is a game or plugin content directory
-		bool bInProjectContent, bInPluginContent;
-		IsUnderGameOrPluginDir(InPath, bInProjectContent, bInPluginContent);
-
-		// Make the path relative to the corresponding content directory
-		const FString Name = FPaths::GetCleanFilename(InPath);
-		FString PrettyPath = InPath;
-		if (bInProjectContent)
+		int32 SchemeIndex = INDEX_NONE;
+		int32 Distance = 0;
+	};
+
+	/** Returns the scheme a folder inherits, by walking up to its closest ancestor that matched a scheme itself. */
+	inline FColorizedFoldersInheritedScheme FindInheritedScheme(const FColorizedFoldersIndex& Index, int32 NodeIndex, TConstArrayView<FColorizedFolderColorScheme> Schemes)
+	{
+		int32 Distance = 1;
+		for (int32 AncestorIndex = Index.GetNode(NodeIndex).Parent; AncestorIndex != INDEX_NONE; AncestorIndex = Index.GetNode(AncestorIndex).Parent, ++Distance)
 		{
-			FPaths::MakePathRelativeTo(PrettyPath, *FPaths::ProjectContentDir());
+			const int32 AncestorScheme = Index.GetNode(AncestorIndex).SchemeIndex;
+			if (AncestorScheme != INDEX_NONE)
+			{
+				return Schemes[AncestorScheme].InheritsTo(Distance) ? FColorizedFoldersInheritedScheme{ AncestorScheme, Distance } : FColorizedFoldersInheritedScheme();
+			}
+		}
+		return FColorizedFoldersInheritedScheme();
+	}
 
-			// Special case for the project content directory
-			PrettyPath = TEXT("/") + InRootName + TEXT("/") + PrettyPath;
+	/** Colors a single folder by its own scheme, or else by the scheme it inherits. Returns the scheme its subfolders inherit. */
+	inline FColorizedFoldersInheritedScheme ColorizeNode(const FColorizedFoldersIndex& Index, int32 NodeIndex, const FColorizedFoldersInheritedScheme& Inherited, TConstArrayView<FColorizedFolderColorScheme> Schemes, FColorizedFoldersAppliedColors& AppliedColors)
+	{
+		// Implicit ancestors like mount roots aren't colored, but still pass on what they inherit
+		const FColorizedFoldersIndex::FNode& Node = Index.GetNode(NodeIndex);
+		if (Node.SchemeIndex != INDEX_NONE)
+		{
+			const FColorizedFolderColorScheme& Scheme = Schemes[Node.SchemeIndex];
+			if (Node.bExplicit)
+			{
+				AppliedColors.SetColor(Node.Path, Scheme.SchemeColor);
+			}
+			return Scheme.InheritsTo(1) ? FColorizedFoldersInheritedScheme{ Node.SchemeIndex, 1 } : FColorizedFoldersInheritedScheme();
 		}
-		else if (bInPluginContent)
+
+		if (Inherited.SchemeIndex != INDEX_NONE)
 		{
-			FPaths::MakePathRelativeTo(PrettyPath, *FPaths::ProjectPluginsDir());
+			const FColorizedFolderColorScheme& Scheme = Schemes[Inherited.SchemeIndex];
+			if (Node.bExplicit)
+			{
+				AppliedColors.SetColor(Node.Path, Scheme.GetInheritedColor(Inherited.Distance));
+			}
+			return Scheme.InheritsTo(Inherited.Distance + 1) ? FColorizedFoldersInheritedScheme{ Inherited.SchemeIndex, Inherited.Distance + 1 } : FColorizedFoldersInheritedScheme();
 		}
 
-		// Remove the virtual path if it exists
-		const FString OldPath = PrettyPath;
-		const int32 ContentIdx = PrettyPath.Find(TEXT("Content"));
-		if (ContentIdx != INDEX_NONE)
+		if (Node.bExplicit)
 		{
-			PrettyPath = TEXT("/") + InRootName + TEXT("/") +  PrettyPath.RightChop(ContentIdx + 8);
+			AppliedColors.ClearColor(Node.Path);
 		}
-		
-		return PrettyPath;
+		return FColorizedFoldersInheritedScheme();
 	}
 
-	/** Colorizes the folders in the content browser with the corresponding theme */
-	inline void ColorizeDirsAccordingToScheme(const TArray<FString>& InDirs, const FColorizedFolderColorScheme& Scheme, TArray<FString>& InOutTracking)
+	/** Colors a folder and its whole subtree in a single top-down pass, which carries the inherited scheme down. */
+	inline void ColorizeSubtree(const FColorizedFoldersIndex& Index, int32 RootIndex, const FColorizedFoldersInheritedScheme& Inherited, TConstArrayView<FColorizedFolderColorScheme> Schemes, FColorizedFoldersAppliedColors& AppliedColors, TBitArray<>& Visited)
 	{
-		// Colorize explicit paths
-		for (const FString& ExplicitDir : Scheme.ResolveExplicitPaths())
+		TArray<TPair<int32, FColorizedFoldersInheritedScheme>> PendingNodes;
+		PendingNodes.Emplace(RootIndex, Inherited);
+		while (!PendingNodes.IsEmpty())
 		{
-			AssetViewUtils::SetPathColor(ExplicitDir, Scheme.SchemeColor);	
+			const TPair<int32, FColorizedFoldersInheritedScheme> Current = PendingNodes.Pop(EAllowShrinking::No);
+			Visited[Current.Key] = true;
+
+			const FColorizedFoldersInheritedScheme ChildInherited = ColorizeNode(Index, Current.Key, Current.Value, Schemes, AppliedColors);
+			for (const int32 ChildIndex : Index.GetNode(Current.Key).Children)
+			{
+				PendingNodes.Emplace(ChildIndex, ChildInherited);
+			}
 		}
+	}
+
+	/**
+	 * Colorizes the folders in the content browser according to the compiled schemes of the active theme.
+	 * Every dirty folder is resolved to its single winning scheme first (see FColorizedFoldersSchemeMatcher for the priority),
+	 * so its color is written at most once, and only if it differs from the color we applied last time.
+	 * Folders that don't match a scheme themselves get the color of their closest matching ancestor, if its scheme is inherited.
+	 *
+	 * @param bFullUpdate	Colors every folder in one top-down pass over the index. Otherwise only the dirty folders are colored,
+	 *						along with the subtrees below folders whose inherited scheme changed.
+	 */
+	inline void ColorizeIndexedFolders(FColorizedFoldersIndex& Index, bool bFullUpdate, TConstArrayView<FColorizedFolderColorScheme> Schemes, const FColorizedFoldersSchemeMatcher& Matcher, const FColorizedFoldersMountTable& MountTable, FColorizedFoldersAppliedColors& AppliedColors)
+	{
+		// Match all dirty folders first, so every folder can rely on the schemes of its ancestors being up to date
+		TArray<int32> DirtyNodes;
+		Index.ConsumeDirtyNodes(DirtyNodes);
+		TRACE_COUNTER_SET(ColorizedFolders_DirtyFolders, DirtyNodes.Num());
 
-		auto IsIncludedByScheme = [Scheme](const FString& Dir)
+		TArray<int32> SubtreeRoots;
 		{
-			for (const FString& FolderName : Scheme.ResolveFolderNames())
+			COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::MatchDirtyFolders");
+			for (const int32 NodeIndex : DirtyNodes)
 			{
-				if (FPaths::GetPathLeaf(Dir) == FolderName)
+				const FColorizedFoldersIndex::FNode& Node = Index.GetNode(NodeIndex);
+				const int32 PreviousSchemeIndex = Node.SchemeIndex;
+				const int32 SchemeIndex = MatchDir(Node.Path, Matcher, MountTable);
+				Index.SetSchemeIndex(NodeIndex, SchemeIndex);
+				if (SchemeIndex != INDEX_NONE)
+				{
+					INC_DWORD_STAT(STAT_ColorizedFolders_FoldersMatched);
+				}
+
+				// The subfolders only have to be colored again if they inherit something else now
+				if (SchemeIndex != PreviousSchemeIndex &&
+					((SchemeIndex != INDEX_NONE && Schemes[SchemeIndex].bInheritToChildren) ||
+					(PreviousSchemeIndex != INDEX_NONE && Schemes[PreviousSchemeIndex].bInheritToChildren)))
 				{
-					return true;
+					SubtreeRoots.Add(NodeIndex);
 				}
 			}
-				
-			return false;
-		};
+		}
+
+		COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::ApplyColors");
 
-		// Colorize individual folders
-		for (const FString& Dir : InDirs)
+		TBitArray<> Visited(false, Index.GetMaxNodeIndex());
+		if (bFullUpdate)
 		{
-			if (IsIncludedByScheme(Dir))
+			TArray<int32> RootNodes;
+			Index.GetRootNodes(RootNodes);
+			for (const int32 RootIndex : RootNodes)
 			{
-				AssetViewUtils::SetPathColor(Dir, Scheme.SchemeColor);
-				InOutTracking.RemoveSingle(Dir);
+				ColorizeSubtree(Index, RootIndex, FColorizedFoldersInheritedScheme(), Schemes, AppliedColors, Visited);
 			}
+			return;
 		}
-	}
-	
-	/** Directory iterator for the Colorized Folders plugin */
-	class FColorizedFoldersDirIterator : public IPlatformFile::FDirectoryVisitor
-	{
-	public:
-		FColorizedFoldersDirIterator(TArray<FString>& InOutDirs)
-			: OutDirs(InOutDirs)
-		{
-		}
-		
-		TArray<FString>& OutDirs;
-		FString VirtualPath, RootName;
 
-		void SetVirtualPath(const FString& InVirtualPath)
+		// Color the outermost subtrees first, so nested ones are skipped instead of being colored twice
+		SubtreeRoots.Sort([&Index](int32 A, int32 B)
 		{
-			VirtualPath = InVirtualPath;
-		}
+			return Index.GetNode(A).Path.Len() < Index.GetNode(B).Path.Len();
+		});
 
-		void SetRootName(const FString& InRootName)
+		for (const int32 NodeIndex : SubtreeRoots)
 		{
-			RootName = InRootName;
+			if (!Visited[NodeIndex])
+			{
+				ColorizeSubtree(Index, NodeIndex, FindInheritedScheme(Index, NodeIndex, Schemes), Schemes, AppliedColors, Visited);
+			}
 		}
 
-		virtual bool Visit(const TCHAR* FilenameOrDirectory, bool bIsDirectory) override
+		// Without any inherited scheme there is no need to look at the ancestors
+		const bool bAnyInherited = Algo::AnyOf(Schemes, [](const FColorizedFolderColorScheme& Scheme) { return Scheme.bInheritToChildren; });
+		for (const int32 NodeIndex : DirtyNodes)
 		{
-			FString FileOrDirString(FilenameOrDirectory);
-			if (bIsDirectory)
+			if (!Visited[NodeIndex])
 			{
-				// No need to check auto-generated folders for wp
-				if (FileOrDirString.Contains(TEXT("__ExternalActors__")) ||
-					FileOrDirString.Contains(TEXT("__ExternalObjects__")))
-				{
-					return true;
-				}
-
-				// Check if the directory is blacklisted
-				for (const auto& BlackListedDir : UColorizedFoldersSettings::Get()->FolderBlacklist)
-				{
-					if (FPaths::IsUnderDirectory(FilenameOrDirectory, BlackListedDir.Path))
-					{
-						return true;
-					}
-				}
+				ColorizeNode(Index, NodeIndex, bAnyInherited ? FindInheritedScheme(Index, NodeIndex, Schemes) : FColorizedFoldersInheritedScheme(), Schemes, AppliedColors);
+			}
+		}
+	}
 
-				// Pretty up the path
-				const FString PrettifiedPath = BuildPrettyDirPath(FilenameOrDirectory, RootName);
+	/** Colorizes explicit paths that are not part of the folder index, e.g. purely virtual folders like "/Plugins/GameFeatures" */
+	inline void ColorizeUnindexedExplicitPaths(const FColorizedFoldersIndex& Index, TConstArrayView<FColorizedFolderColorScheme> Schemes, const FColorizedFoldersSchemeMatcher& Matcher, const FColorizedFoldersMountTable& MountTable, FColorizedFoldersAppliedColors& AppliedColors)
+	{
+		COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::ColorizeUnindexedExplicitPaths");
 
-				// Add the directory to the list
-				OutDirs.Add(PrettifiedPath);
+		for (const TPair<FString, int32>& ExplicitPath : Matcher.GetExplicitPaths())
+		{
+			// Paths written as they're shown in the Content Browser are matched through the folder index already
+			TStringBuilder<512> PackagePath;
+			const bool bIsVirtualPath = MountTable.TryConvertVirtualToPackagePath(ExplicitPath.Key, PackagePath);
+			if (!Index.Contains(ExplicitPath.Key) && !(bIsVirtualPath && Index.Contains(FString(PackagePath))))
+			{
+				AppliedColors.SetColor(ExplicitPath.Key, Schemes[ExplicitPath.Value].SchemeColor);
 			}
-			
-			return true;
 		}
-	};
-}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,705 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "ColorizedFoldersBenchmarkCommandlet.h"
+
+#include "ColorizedFoldersUtils.h"
+#include "Algo/Count.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Folders/ColorizedFoldersAppliedColors.h"
+#include "Folders/ColorizedFoldersGlobAutomaton.h"
+#include "Folders/ColorizedFoldersIndex.h"
+#include "Folders/ColorizedFoldersIndexCache.h"
+#include "Folders/ColorizedFoldersMountTable.h"
+#include "Folders/ColorizedFoldersScanner.h"
+#include "HAL/FileManager.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformFileManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/ScopeExit.h"
+#include "Serialization/JsonWriter.h"
+#include "Themes/ColorizedFoldersManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ColorizedFoldersBenchmarkCommandlet)
+
+DEFINE_LOG_CATEGORY_STATIC(LogColorizedFoldersBenchmark, Log, All);
+
+namespace UE::ColorizedFolders::Private
+{
+	/** Shape of the synthetic project tree. */
+	struct FBenchmarkTreeShape
+	{
+		/** Number of folders to generate across all mount points, not counting the external actor folders. */
+		int32 NumFolders = 10000;
+
+		int32 MaxDepth = 6;
+
+		/** Average number of subfolders per folder. */
+		int32 FanOut = 8;
+
+		/** Number of plugin mount points next to the game content. */
+		int32 NumPlugins = 4;
+
+		/** Chance of a folder to contain an "__ExternalActors__" folder, as World Partition levels do. */
+		float ExternalActorsDensity = 0.02f;
+
+		/** Number of generated folders to add to the blacklist. */
+		int32 NumBlacklisted = 0;
+
+		int32 Seed = 0;
+	};
+
+	/** The generated tree, mounted the same way as the project and its plugins. */
+	struct FBenchmarkTree
+	{
+		FColorizedFoldersMountTable MountTable;
+
+		/** Package paths of all generated folders, except for the mount roots and the external actor folders. */
+		TArray<FString> PackagePaths;
+
+		/** Number of folders generated below "__ExternalActors__", which the scan should never visit. */
+		int32 NumExternalFolders = 0;
+
+		TArray<FDirectoryPath> Blacklist;
+	};
+
+	/** Measurements of one phase of the pipeline. */
+	struct FBenchmarkPhase
+	{
+		explicit FBenchmarkPhase(const TCHAR* InName)
+			: Name(InName)
+		{
+		}
+
+		FString Name;
+
+		/** Wall time of every iteration. */
+		TArray<double> Milliseconds;
+
+		/** Number of heap allocations and reallocations during every iteration, see FBenchmarkMallocCounter. */
+		TArray<int64> NumAllocations;
+
+		/** Number of bytes requested by those allocations. */
+		TArray<int64> AllocatedBytes;
+
+		/** Number of folders the phase processed, in its last iteration. */
+		int32 NumFolders = 0;
+
+		/** Number of folders that matched a scheme, or got colored, in its last iteration. */
+		int32 NumMatched = 0;
+
+		/** Number of folder colors written or cleared, in its last iteration. */
+		uint64 NumWrites = 0;
+	};
+
+	/**
+	 * Forwards to the allocator it wraps and counts every allocation on the way.
+	 * Installed as GMalloc while the benchmark runs, so it also counts the allocations of other threads, such as the workers of the parallel scan.
+	 */
+	class FBenchmarkMallocCounter final : public FMalloc
+	{
+	public:
+		explicit FBenchmarkMallocCounter(FMalloc* InInnerMalloc)
+			: InnerMalloc(InInnerMalloc)
+		{
+		}
+
+		/** Returns the number of allocations and the number of bytes they requested so far. */
+		void GetCounts(int64& OutNumAllocations, int64& OutAllocatedBytes) const
+		{
+			OutNumAllocations = NumAllocations.load(std::memory_order_relaxed);
+			OutAllocatedBytes = AllocatedBytes.load(std::memory_order_relaxed);
+		}
+
+		//~ Begin FMalloc Interface
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			AddAllocation(Count);
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			AddAllocation(Count);
+			return InnerMalloc->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			// Growing or shrinking may move the allocation, freeing it doesn't allocate anything
+			if (Count > 0)
+			{
+				AddAllocation(Count);
+			}
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				AddAllocation(Count);
+			}
+			return InnerMalloc->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			InnerMalloc->Free(Original);
+		}
+
+		virtual SIZE_T QuickSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return InnerMalloc->QuickSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return InnerMalloc->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim(bool bTrimThreadCaches) override
+		{
+			InnerMalloc->Trim(bTrimThreadCaches);
+		}
+
+		virtual void SetupTLSCachesOnCurrentThread() override
+		{
+			InnerMalloc->SetupTLSCachesOnCurrentThread();
+		}
+
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+		{
+			InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+		}
+
+		virtual void UpdateStats() override
+		{
+			InnerMalloc->UpdateStats();
+		}
+
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override
+		{
+			InnerMalloc->GetAllocatorStats(OutStats);
+		}
+
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override
+		{
+			InnerMalloc->DumpAllocatorStats(Ar);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return InnerMalloc->IsInternallyThreadSafe();
+		}
+
+		virtual bool ValidateHeap() override
+		{
+			return InnerMalloc->ValidateHeap();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return InnerMalloc->GetDescriptiveName();
+		}
+		//~ End FMalloc Interface
+
+	private:
+		void AddAllocation(SIZE_T InSize)
+		{
+			NumAllocations.fetch_add(1, std::memory_order_relaxed);
+			AllocatedBytes.fetch_add(static_cast<int64>(InSize), std::memory_order_relaxed);
+		}
+
+		FMalloc* InnerMalloc;
+		std::atomic<int64> NumAllocations = 0;
+		std::atomic<int64> AllocatedBytes = 0;
+	};
+
+	/** The allocation counter, once installed. Never destroyed, other threads may still be inside of it after GMalloc has been restored. */
+	FBenchmarkMallocCounter* MallocCounter = nullptr;
+
+	/** Wraps GMalloc in the allocation counter, until the returned scope ends. */
+	[[nodiscard]] auto InstallMallocCounter()
+	{
+		FMalloc* PreviousMalloc = GMalloc;
+		if (MallocCounter == nullptr)
+		{
+			MallocCounter = new FBenchmarkMallocCounter(PreviousMalloc);
+		}
+		GMalloc = MallocCounter;
+
+		return MakeScopeExit([PreviousMalloc]()
+		{
+			GMalloc = PreviousMalloc;
+		});
+	}
+
+	/** Folder names of the generated tree. Includes the names the theme's schemes use, so the tree actually matches them. */
+	void GatherFolderNames(TConstArrayView<FColorizedFolderColorScheme> Schemes, TArray<FString>& OutNames)
+	{
+		OutNames = { TEXT("Materials"), TEXT("Textures"), TEXT("Meshes"), TEXT("Blueprints"), TEXT("Maps"), TEXT("Audio"), TEXT("Data") };
+
+		TArray<FString> Entries;
+		for (const FColorizedFolderColorScheme& Scheme : Schemes)
+		{
+			Entries.Reset();
+			Scheme.FolderNames.ParseIntoArray(Entries, TEXT(","), true);
+			for (FString& FolderName : Entries)
+			{
+				FolderName.TrimStartAndEndInline();
+				if (!FolderName.IsEmpty() && !FColorizedFoldersGlobAutomaton::IsPattern(FolderName))
+				{
+					OutNames.AddUnique(MoveTemp(FolderName));
+				}
+			}
+		}
+	}
+
+	/** Creates the content dirs of the game and its plugins below InRootDir, and fills each of them breadth first until its share of folders is used up. */
+	void GenerateTree(const FBenchmarkTreeShape& Shape, TConstArrayView<FString> FolderNames, const FString& InRootDir, FBenchmarkTree& OutTree)
+	{
+		// Subfolders per level below an "__ExternalActors__" folder, and the number of levels
+		static constexpr int32 ExternalFanOut = 4;
+		static constexpr int32 ExternalDepth = 2;
+
+		struct FGeneratedDir
+		{
+			FString Dir;
+			FString PackagePath;
+			int32 Depth;
+		};
+
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		FRandomStream Random(Shape.Seed);
+
+		// The game usually holds most of the content, the plugins share the rest
+		const int32 GameBudget = Shape.NumPlugins > 0 ? Shape.NumFolders / 2 : Shape.NumFolders;
+		const int32 PluginBudget = Shape.NumPlugins > 0 ? (Shape.NumFolders - GameBudget) / Shape.NumPlugins : 0;
+
+		TArray<FGeneratedDir> PendingDirs;
+		TSet<FString> SiblingNames;
+		for (int32 MountIdx = 0; MountIdx <= Shape.NumPlugins; ++MountIdx)
+		{
+			const FString MountName = MountIdx == 0 ? FString(TEXT("Game")) : FString::Printf(TEXT("BenchmarkPlugin%d"), MountIdx);
+			const FString ContentDir = InRootDir / MountName / TEXT("Content");
+			PlatformFile.CreateDirectoryTree(*ContentDir);
+			OutTree.MountTable.AddMountPoint(MountName, ContentDir, MountIdx == 0 ? FString(TEXT("/Game")) : FColorizedFoldersMountTable::MakePluginVirtualRoot(MountName, FString()));
+
+			const int32 Budget = MountIdx == 0 ? GameBudget : PluginBudget;
+			int32 NumGenerated = 0;
+
+			PendingDirs.Reset();
+			PendingDirs.Add({ ContentDir, TEXT("/") + MountName, 0 });
+			for (int32 PendingIdx = 0; PendingIdx < PendingDirs.Num() && NumGenerated < Budget; ++PendingIdx)
+			{
+				// Adding children may reallocate the array
+				const FGeneratedDir Parent = PendingDirs[PendingIdx];
+				if (Parent.Depth >= Shape.MaxDepth)
+				{
+					continue;
+				}
+
+				const int32 NumChildren = FMath::Min(Random.RandRange(FMath::Max(Shape.FanOut / 2, 1), Shape.FanOut + Shape.FanOut / 2), Budget - NumGenerated);
+				SiblingNames.Reset();
+				for (int32 ChildIdx = 0; ChildIdx < NumChildren; ++ChildIdx)
+				{
+					// Every fourth folder is named after a scheme, or some other common content folder
+					FString Name = Random.FRand() < 0.25f ? FolderNames[Random.RandHelper(FolderNames.Num())] : FString();
+					if (Name.IsEmpty() || SiblingNames.Contains(Name))
+					{
+						Name = FString::Printf(TEXT("Folder%d"), ChildIdx);
+					}
+					SiblingNames.Add(Name);
+
+					const FGeneratedDir& Child = PendingDirs.Add_GetRef({ Parent.Dir / Name, Parent.PackagePath / Name, Parent.Depth + 1 });
+					PlatformFile.CreateDirectory(*Child.Dir);
+					OutTree.PackagePaths.Add(Child.PackagePath);
+					++NumGenerated;
+
+					if (Random.FRand() < Shape.ExternalActorsDensity)
+					{
+						const FString ExternalDir = Child.Dir / TEXT("__ExternalActors__");
+						PlatformFile.CreateDirectory(*ExternalDir);
+						++OutTree.NumExternalFolders;
+
+						TArray<FString> ExternalLevel = { ExternalDir };
+						for (int32 Level = 0; Level < ExternalDepth; ++Level)
+						{
+							TArray<FString> NextLevel;
+							for (const FString& LevelDir : ExternalLevel)
+							{
+								for (int32 ExternalIdx = 0; ExternalIdx < ExternalFanOut; ++ExternalIdx)
+								{
+									const FString& ExternalChild = NextLevel.Add_GetRef(LevelDir / FString::Printf(TEXT("%X"), Random.RandHelper(256)));
+									PlatformFile.CreateDirectory(*ExternalChild);
+								}
+							}
+							OutTree.NumExternalFolders += NextLevel.Num();
+							ExternalLevel = MoveTemp(NextLevel);
+						}
+					}
+				}
+			}
+		}
+
+		for (int32 BlacklistIdx = 0; BlacklistIdx < Shape.NumBlacklisted && !OutTree.PackagePaths.IsEmpty(); ++BlacklistIdx)
+		{
+			OutTree.Blacklist.AddDefaulted_GetRef().Path = OutTree.PackagePaths[Random.RandHelper(OutTree.PackagePaths.Num())];
+		}
+	}
+
+	/** Runs a phase for the given number of iterations, recording its wall time and its allocations. */
+	void RunPhase(FBenchmarkPhase& Phase, int32 NumIterations, TFunctionRef<void(FBenchmarkPhase&)> Iteration)
+	{
+		check(MallocCounter && GMalloc == MallocCounter);
+
+		for (int32 IterationIdx = 0; IterationIdx < NumIterations; ++IterationIdx)
+		{
+			int64 NumAllocationsBefore, AllocatedBytesBefore;
+			MallocCounter->GetCounts(NumAllocationsBefore, AllocatedBytesBefore);
+			const double StartTime = FPlatformTime::Seconds();
+
+			Iteration(Phase);
+
+			Phase.Milliseconds.Add((FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+			int64 NumAllocationsAfter, AllocatedBytesAfter;
+			MallocCounter->GetCounts(NumAllocationsAfter, AllocatedBytesAfter);
+			Phase.NumAllocations.Add(NumAllocationsAfter - NumAllocationsBefore);
+			Phase.AllocatedBytes.Add(AllocatedBytesAfter - AllocatedBytesBefore);
+		}
+
+		const double MinMilliseconds = FMath::Min(Phase.Milliseconds);
+		UE_LOG(LogColorizedFoldersBenchmark, Display, TEXT("%-17s %10.2f ms (best of %d), %d folders, %d matched, %llu color writes, %lld allocations"),
+			*Phase.Name, MinMilliseconds, Phase.Milliseconds.Num(), Phase.NumFolders, Phase.NumMatched, Phase.NumWrites, Phase.NumAllocations.Last());
+	}
+
+	/** Writes the tree shape and the measurements of all phases as JSON. */
+	bool WriteReport(const FBenchmarkTreeShape& Shape, const FBenchmarkTree& Tree, const FString& ThemeName, TConstArrayView<FBenchmarkPhase> Phases, const FString& InFilename)
+	{
+		FString Output;
+		TSharedRef<TJsonWriter<>> WriterRef = TJsonWriterFactory<>::Create(&Output);
+		TJsonWriter<>& Writer = WriterRef.Get();
+		Writer.WriteObjectStart();
+		Writer.WriteValue(TEXT("Version"), 2);
+		Writer.WriteValue(TEXT("Theme"), ThemeName);
+
+		Writer.WriteObjectStart(TEXT("Tree"));
+		Writer.WriteValue(TEXT("Folders"), Tree.PackagePaths.Num());
+		Writer.WriteValue(TEXT("ExternalFolders"), Tree.NumExternalFolders);
+		Writer.WriteValue(TEXT("MountPoints"), Tree.MountTable.GetMountPoints().Num());
+		Writer.WriteValue(TEXT("MaxDepth"), Shape.MaxDepth);
+		Writer.WriteValue(TEXT("FanOut"), Shape.FanOut);
+		Writer.WriteValue(TEXT("ExternalActorsDensity"), Shape.ExternalActorsDensity);
+		Writer.WriteValue(TEXT("Blacklist"), Tree.Blacklist.Num());
+		Writer.WriteValue(TEXT("Seed"), Shape.Seed);
+		Writer.WriteObjectEnd();
+
+		Writer.WriteArrayStart(TEXT("Phases"));
+		for (const FBenchmarkPhase& Phase : Phases)
+		{
+			double TotalMilliseconds = 0.0;
+			for (const double Milliseconds : Phase.Milliseconds)
+			{
+				TotalMilliseconds += Milliseconds;
+			}
+
+			Writer.WriteObjectStart();
+			Writer.WriteValue(TEXT("Name"), Phase.Name);
+			Writer.WriteValue(TEXT("Iterations"), Phase.Milliseconds.Num());
+			Writer.WriteValue(TEXT("AvgMs"), TotalMilliseconds / Phase.Milliseconds.Num());
+			Writer.WriteValue(TEXT("MinMs"), FMath::Min(Phase.Milliseconds));
+			Writer.WriteValue(TEXT("MaxMs"), FMath::Max(Phase.Milliseconds));
+			Writer.WriteValue(TEXT("Folders"), Phase.NumFolders);
+			Writer.WriteValue(TEXT("Matched"), Phase.NumMatched);
+			Writer.WriteValue(TEXT("SetPathColorCalls"), static_cast<int64>(Phase.NumWrites));
+
+			Writer.WriteArrayStart(TEXT("Milliseconds"));
+			for (const double Milliseconds : Phase.Milliseconds)
+			{
+				Writer.WriteValue(Milliseconds);
+			}
+			Writer.WriteArrayEnd();
+
+			Writer.WriteArrayStart(TEXT("Allocations"));
+			for (const int64 NumAllocations : Phase.NumAllocations)
+			{
+				Writer.WriteValue(NumAllocations);
+			}
+			Writer.WriteArrayEnd();
+
+			Writer.WriteArrayStart(TEXT("AllocatedBytes"));
+			for (const int64 AllocatedBytes : Phase.AllocatedBytes)
+			{
+				Writer.WriteValue(AllocatedBytes);
+			}
+			Writer.WriteArrayEnd();
+
+			Writer.WriteObjectEnd();
+		}
+		Writer.WriteArrayEnd();
+
+		Writer.WriteObjectEnd();
+		Writer.Close();
+
+		return FFileHelper::SaveStringToFile(Output, *InFilename);
+	}
+}
+
+UColorizedFoldersBenchmarkCommandlet::UColorizedFoldersBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UColorizedFoldersBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace UE::ColorizedFolders;
+	using namespace UE::ColorizedFolders::Private;
+
+	FBenchmarkTreeShape Shape;
+	FParse::Value(*Params, TEXT("Folders="), Shape.NumFolders);
+	FParse::Value(*Params, TEXT("Depth="), Shape.MaxDepth);
+	FParse::Value(*Params, TEXT("FanOut="), Shape.FanOut);
+	FParse::Value(*Params, TEXT("Plugins="), Shape.NumPlugins);
+	FParse::Value(*Params, TEXT("ExternalActors="), Shape.ExternalActorsDensity);
+	FParse::Value(*Params, TEXT("Blacklist="), Shape.NumBlacklisted);
+	FParse::Value(*Params, TEXT("Seed="), Shape.Seed);
+	Shape.NumFolders = FMath::Max(Shape.NumFolders, 1);
+	Shape.MaxDepth = FMath::Max(Shape.MaxDepth, 1);
+	Shape.FanOut = FMath::Max(Shape.FanOut, 1);
+	Shape.NumPlugins = FMath::Max(Shape.NumPlugins, 0);
+
+	int32 NumIterations = 3;
+	FParse::Value(*Params, TEXT("Iterations="), NumIterations);
+	NumIterations = FMath::Max(NumIterations, 1);
+
+	FString OutputFilename = FPaths::ProjectSavedDir() / TEXT("ColorizedFolders") / TEXT("Benchmark.json");
+	FParse::Value(*Params, TEXT("Output="), OutputFilename);
+
+	const bool bWriteColors = FParse::Param(*Params, TEXT("WriteColors"));
+	const bool bKeepTree = FParse::Param(*Params, TEXT("KeepTree"));
+
+	TArray<FBenchmarkPhase> Phases;
+	FString ThemeName;
+
+	const auto RestoreMalloc = InstallMallocCounter();
+
+#if ALLOW_THEMES
+	// Load the themes the same way the editor does on startup
+	UColorizedFoldersManager& Manager = UColorizedFoldersManager::Get();
+	const FGuid PreviousThemeId = UColorizedFoldersManager::GetCurrentThemeId();
+	RunPhase(Phases.Emplace_GetRef(TEXT("LoadThemes")), NumIterations, [&Manager](FBenchmarkPhase&)
+	{
+		Manager.LoadThemes();
+	});
+
+	FString ThemeParam;
+	if (FParse::Value(*Params, TEXT("Theme="), ThemeParam))
+	{
+		FGuid ThemeId;
+		if (!FGuid::Parse(ThemeParam, ThemeId))
+		{
+			const FColorizedFolderTheme* Theme = Manager.GetThemes().FindByPredicate([&ThemeParam](const FColorizedFolderTheme& Theme)
+			{
+				return Theme.DisplayName.ToString().Equals(ThemeParam, ESearchCase::IgnoreCase);
+			});
+			ThemeId = Theme ? Theme->Id : FGuid();
+		}
+
+		if (Manager.FindTheme(ThemeId) == nullptr)
+		{
+			UE_LOG(LogColorizedFoldersBenchmark, Error, TEXT("Unknown theme '%s'."), *ThemeParam);
+			return 1;
+		}
+
+		// Only the first iteration compiles the theme, later ones publish the cached snapshot
+		RunPhase(Phases.Emplace_GetRef(TEXT("ApplyTheme")), NumIterations, [&Manager, ThemeId](FBenchmarkPhase&)
+		{
+			Manager.ApplyTheme(ThemeId);
+		});
+	}
+	ThemeName = Manager.GetCurrentTheme().DisplayName.ToString();
+#endif
+
+	const FColorizedFoldersSchemeSnapshotRef Snapshot = UColorizedFoldersManager::GetSchemeSnapshot();
+	const TConstArrayView<FColorizedFolderColorScheme> Schemes = Snapshot->Schemes;
+	const FColorizedFoldersSchemeMatcher& Matcher = Snapshot->Matcher;
+
+	// Start from a fresh tree, the scans would pick up leftovers of a previous run otherwise
+	const FString TreeDir = FPaths::ProjectSavedDir() / TEXT("ColorizedFolders") / TEXT("BenchmarkTree");
+	IFileManager::Get().DeleteDirectory(*TreeDir, false, true);
+
+	TArray<FString> FolderNames;
+	GatherFolderNames(Schemes, FolderNames);
+
+	FBenchmarkTree Tree;
+	RunPhase(Phases.Emplace_GetRef(TEXT("Generate")), 1, [&](FBenchmarkPhase& Phase)
+	{
+		GenerateTree(Shape, FolderNames, TreeDir, Tree);
+		Phase.NumFolders = Tree.PackagePaths.Num() + Tree.NumExternalFolders;
+	});
+
+	FColorizedFoldersDirScanner Scanner;
+	Scanner.SetBlacklist(Tree.Blacklist);
+
+	auto MatchFolder = [&Matcher, &Mounts = Tree.MountTable](const FString& Dir, const FColorizedFoldersPathState* ParentState, FColorizedFoldersPathState& OutState)
+	{
+		return MatchDir(Dir, Matcher, Mounts, ParentState, &OutState);
+	};
+	auto IsCancelled = []()
+	{
+		return false;
+	};
+	auto CountMatched = [](TConstArrayView<int32> SchemeIndices)
+	{
+		return static_cast<int32>(Algo::CountIf(SchemeIndices, [](int32 SchemeIndex) { return SchemeIndex != INDEX_NONE; }));
+	};
+
+	// Lists every directory, same as the first scan without an index cache
+	FColorizedFoldersScanResult ScanResult;
+	RunPhase(Phases.Emplace_GetRef(TEXT("Scan")), NumIterations, [&](FBenchmarkPhase& Phase)
+	{
+		ScanResult = FColorizedFoldersScanResult();
+		Scanner.Scan(Tree.MountTable.GetMountPoints(), nullptr, MatchFolder, IsCancelled, ScanResult);
+		Phase.NumFolders = ScanResult.Dirs.Num();
+		Phase.NumMatched = CountMatched(ScanResult.SchemeIndices);
+	});
+
+	// Nothing changed on disk, so every directory reuses its cached children
+	FColorizedFoldersIndexCache IndexCache;
+	IndexCache.Build(ScanResult, FColorizedFoldersAppliedColors());
+	RunPhase(Phases.Emplace_GetRef(TEXT("ScanCached")), NumIterations, [&](FBenchmarkPhase& Phase)
+	{
+		FColorizedFoldersScanResult CachedScanResult;
+		Scanner.Scan(Tree.MountTable.GetMountPoints(), &IndexCache, MatchFolder, IsCancelled, CachedScanResult);
+		Phase.NumFolders = CachedScanResult.Dirs.Num();
+		Phase.NumMatched = CountMatched(CachedScanResult.SchemeIndices);
+	});
+
+	// Lists the same folders from the Asset Registry's cached path tree, as the default scan source does.
+	// The plugins are mounted and the generated folders added to the path tree up front, and removed again afterwards, without being timed.
+	// Folders of the project the Asset Registry already knows about are listed as well, since the game content is mounted as /Game.
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	TArray<const FColorizedFoldersMountPoint*> RegisteredMountPoints;
+	for (const FColorizedFoldersMountPoint& MountPoint : Tree.MountTable.GetMountPoints())
+	{
+		if (!FPackageName::MountPointExists(MountPoint.PackageRoot))
+		{
+			FPackageName::RegisterMountPoint(MountPoint.PackageRoot + TEXT("/"), MountPoint.ContentDir + TEXT("/"));
+			RegisteredMountPoints.Add(&MountPoint);
+		}
+	}
+
+	int32 NumRejectedPaths = 0;
+	for (const FString& PackagePath : Tree.PackagePaths)
+	{
+		NumRejectedPaths += AssetRegistry.AddPath(PackagePath) ? 0 : 1;
+	}
+	UE_CLOG(NumRejectedPaths > 0, LogColorizedFoldersBenchmark, Warning, TEXT("The Asset Registry rejected %d of the generated folders."), NumRejectedPaths);
+
+	RunPhase(Phases.Emplace_GetRef(TEXT("ScanAssetRegistry")), NumIterations, [&](FBenchmarkPhase& Phase)
+	{
+		FColorizedFoldersScanResult AssetRegistryScanResult;
+		Scanner.Scan(AssetRegistry, Tree.MountTable.GetMountPoints(), MatchFolder, IsCancelled, AssetRegistryScanResult);
+		Phase.NumFolders = AssetRegistryScanResult.Dirs.Num();
+		Phase.NumMatched = CountMatched(AssetRegistryScanResult.SchemeIndices);
+	});
+
+	// Children were generated after their parents, so removing in reverse never removes a folder that still has generated children
+	for (int32 PathIdx = Tree.PackagePaths.Num() - 1; PathIdx >= 0; --PathIdx)
+	{
+		AssetRegistry.RemovePath(Tree.PackagePaths[PathIdx]);
+	}
+
+	for (const FColorizedFoldersMountPoint* MountPoint : RegisteredMountPoints)
+	{
+		FPackageName::UnRegisterMountPoint(MountPoint->PackageRoot + TEXT("/"), MountPoint->ContentDir + TEXT("/"));
+	}
+
+	// Matches every folder on its own, without the path pattern state of its parent, as single folder updates do
+	RunPhase(Phases.Emplace_GetRef(TEXT("Match")), NumIterations, [&](FBenchmarkPhase& Phase)
+	{
+		Phase.NumMatched = 0;
+		for (const FString& Dir : ScanResult.Dirs)
+		{
+			Phase.NumMatched += MatchDir(Dir, Matcher, Tree.MountTable) != INDEX_NONE ? 1 : 0;
+		}
+		Phase.NumFolders = ScanResult.Dirs.Num();
+	});
+
+	// Installs the scan result as the folder index and colors it from scratch, as the first update of a session does
+	FColorizedFoldersIndex FolderIndex;
+	TUniquePtr<FColorizedFoldersAppliedColors> AppliedColors;
+	auto ApplyColors = [&](FBenchmarkPhase& Phase)
+	{
+		const uint64 NumWritesBefore = AppliedColors->GetNumWrites();
+
+		FolderIndex.Reset();
+		for (int32 DirIdx = 0; DirIdx < ScanResult.Dirs.Num(); ++DirIdx)
+		{
+			FolderIndex.SetSchemeIndex(FolderIndex.AddFolder(ScanResult.Dirs[DirIdx]), ScanResult.SchemeIndices[DirIdx]);
+		}
+		FolderIndex.ClearDirtyFolders();
+
+		AppliedColors->BeginWriteBatch();
+		AppliedColors->BeginFullUpdate();
+		ColorizeIndexedFolders(FolderIndex, true, Schemes, Matcher, Tree.MountTable, *AppliedColors);
+		ColorizeUnindexedExplicitPaths(FolderIndex, Schemes, Matcher, Tree.MountTable, *AppliedColors);
+		AppliedColors->EndFullUpdate();
+		AppliedColors->EndWriteBatch();
+
+		Phase.NumFolders = FolderIndex.Num();
+		Phase.NumMatched = AppliedColors->Num();
+		Phase.NumWrites = AppliedColors->GetNumWrites() - NumWritesBefore;
+	};
+
+	RunPhase(Phases.Emplace_GetRef(TEXT("Apply")), NumIterations, [&](FBenchmarkPhase& Phase)
+	{
+		AppliedColors = MakeUnique<FColorizedFoldersAppliedColors>();
+		AppliedColors->SetWritesEnabled(bWriteColors);
+		ApplyColors(Phase);
+	});
+
+	// Colors everything again on top of the previous update, which shouldn't write anything
+	RunPhase(Phases.Emplace_GetRef(TEXT("Reapply")), NumIterations, ApplyColors);
+
+	// Clear every color we applied, so -WriteColors doesn't leave the colors of the synthetic folders behind
+	RunPhase(Phases.Emplace_GetRef(TEXT("Clear")), 1, [&](FBenchmarkPhase& Phase)
+	{
+		const uint64 NumWritesBefore = AppliedColors->GetNumWrites();
+		Phase.NumFolders = AppliedColors->Num();
+		AppliedColors->BeginWriteBatch();
+		AppliedColors->BeginFullUpdate();
+		AppliedColors->EndFullUpdate();
+		AppliedColors->EndWriteBatch();
+		Phase.NumWrites = AppliedColors->GetNumWrites() - NumWritesBefore;
+	});
+
+	if (!bKeepTree)
+	{
+		IFileManager::Get().DeleteDirectory(*TreeDir, false, true);
+	}
+
+#if ALLOW_THEMES
+	// The theme to benchmark shouldn't replace the theme of the user
+	if (UColorizedFoldersManager::GetCurrentThemeId() != PreviousThemeId)
+	{
+		Manager.ApplyTheme(PreviousThemeId);
+	}
+#endif
+
+	if (!WriteReport(Shape, Tree, ThemeName, Phases, OutputFilename))
+	{
+		UE_LOG(LogColorizedFoldersBenchmark, Error, TEXT("Failed to write the report to '%s'."), *OutputFilename);
+		return 1;
+	}
+
+	UE_LOG(LogColorizedFoldersBenchmark, Display, TEXT("Wrote the report to '%s'."), *FPaths::ConvertRelativePathToFull(OutputFilename));
+	return 0;
+}
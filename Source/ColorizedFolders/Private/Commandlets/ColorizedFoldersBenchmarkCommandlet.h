@@ -0,0 +1,30 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "ColorizedFoldersBenchmarkCommandlet.generated.h"
+
+/**
+ * Generates a synthetic project tree and measures the scan, match and apply pipeline against it.
+ * The timings and heap allocations of every phase are written as JSON, so runs with different tree shapes or builds can be compared.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=ColorizedFoldersBenchmark [-Folders=10000] [-Depth=6] [-FanOut=8] [-Plugins=4]
+ *		[-ExternalActors=0.02] [-Blacklist=0] [-Seed=0] [-Theme=<Name or Id>] [-Iterations=3] [-Output=<File>] [-WriteColors] [-KeepTree]
+ *
+ * Colors are only counted, not written to the editor config, unless -WriteColors is passed.
+ */
+UCLASS()
+class UColorizedFoldersBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UColorizedFoldersBenchmarkCommandlet();
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
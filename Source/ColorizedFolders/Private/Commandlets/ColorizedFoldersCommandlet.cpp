@@ -0,0 +1,96 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "ColorizedFoldersCommandlet.h"
+
+#include "ColorizedFoldersSettings.h"
+#include "ColorizedFoldersUtils.h"
+#include "Folders/ColorizedFoldersAppliedColors.h"
+#include "Folders/ColorizedFoldersIndex.h"
+#include "Folders/ColorizedFoldersIndexCache.h"
+#include "Folders/ColorizedFoldersMountTable.h"
+#include "Folders/ColorizedFoldersScanner.h"
+#include "Themes/ColorizedFoldersManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ColorizedFoldersCommandlet)
+
+DEFINE_LOG_CATEGORY_STATIC(LogColorizedFoldersCommandlet, Log, All);
+
+UColorizedFoldersCommandlet::UColorizedFoldersCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UColorizedFoldersCommandlet::Main(const FString& Params)
+{
+	using namespace UE::ColorizedFolders;
+
+	const double StartTime = FPlatformTime::Seconds();
+	UColorizedFoldersSettings* Settings = UColorizedFoldersSettings::GetMutable();
+
+	FString OutputFilename = Settings->GetPrecomputedFolderIndexFilename();
+	FParse::Value(*Params, TEXT("Output="), OutputFilename);
+
+	// Resolve the folders against the same theme the editor applies on startup
+	FString ThemeName;
+#if ALLOW_THEMES
+	UColorizedFoldersManager& Manager = UColorizedFoldersManager::Get();
+	Manager.LoadThemes();
+	Settings->Init();
+	Manager.StopWatchingThemeDirectories();
+	ThemeName = Manager.GetCurrentTheme().DisplayName.ToString();
+#endif
+
+	const FColorizedFoldersSchemeSnapshotRef Snapshot = UColorizedFoldersManager::GetSchemeSnapshot();
+	const FColorizedFoldersSchemeMatcher& Matcher = Snapshot->Matcher;
+
+	FColorizedFoldersMountTable MountTable;
+	MountTable.Build();
+
+	FColorizedFoldersDirScanner Scanner;
+	Scanner.SetBlacklist(Settings->FolderBlacklist);
+
+	// Every directory is listed by its own task, so the scan is spread across all worker threads
+	FColorizedFoldersScanResult ScanResult;
+	Scanner.Scan(MountTable.GetMountPoints(), nullptr,
+		[&Matcher, &MountTable](const FString& Dir, const FColorizedFoldersPathState* ParentState, FColorizedFoldersPathState& OutState)
+		{
+			return MatchDir(Dir, Matcher, MountTable, ParentState, &OutState);
+		},
+		[]()
+		{
+			return false;
+		},
+		ScanResult);
+
+	FColorizedFoldersIndex FolderIndex;
+	for (int32 DirIdx = 0; DirIdx < ScanResult.Dirs.Num(); ++DirIdx)
+	{
+		FolderIndex.SetSchemeIndex(FolderIndex.AddFolder(ScanResult.Dirs[DirIdx]), ScanResult.SchemeIndices[DirIdx]);
+	}
+	FolderIndex.ClearDirtyFolders();
+
+	// Resolve the final colors, including the inherited ones, without writing them to the config of this machine
+	FColorizedFoldersAppliedColors AppliedColors;
+	AppliedColors.SetWritesEnabled(false);
+	AppliedColors.BeginFullUpdate();
+	ColorizeIndexedFolders(FolderIndex, true, Snapshot->Schemes, Matcher, MountTable, AppliedColors);
+	AppliedColors.EndFullUpdate();
+
+	FColorizedFoldersIndexCache PrecomputedIndex;
+	PrecomputedIndex.Build(ScanResult, AppliedColors);
+	PrecomputedIndex.SetSchemes(UColorizedFoldersManager::GetCurrentThemeId(), Snapshot->GetSchemesHash());
+	if (!PrecomputedIndex.Save(OutputFilename))
+	{
+		UE_LOG(LogColorizedFoldersCommandlet, Error, TEXT("Failed to write the precomputed folder index to '%s'."), *OutputFilename);
+		return 1;
+	}
+
+	UE_LOG(LogColorizedFoldersCommandlet, Display, TEXT("Resolved %d folders in %d mount points for theme '%s', %d of them colored, %d pruned. Took %.2f s."),
+		ScanResult.Dirs.Num(), ScanResult.Roots.Num(), *ThemeName, AppliedColors.Num(), ScanResult.NumPruned, FPlatformTime::Seconds() - StartTime);
+	UE_LOG(LogColorizedFoldersCommandlet, Display, TEXT("Wrote the precomputed folder index to '%s'."), *FPaths::ConvertRelativePathToFull(OutputFilename));
+	return 0;
+}
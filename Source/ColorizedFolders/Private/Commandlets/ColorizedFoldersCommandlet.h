@@ -0,0 +1,30 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "ColorizedFoldersCommandlet.generated.h"
+
+/**
+ * Scans all content roots of the project, resolves the scheme and color of every folder for the current theme,
+ * and writes the result as a precomputed folder index. Editors apply that file on startup instead of scanning,
+ * as long as their theme and schemes match. Meant to run on build machines, e.g. as part of a nightly job.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=ColorizedFolders [-Output=<File>]
+ *
+ * The output defaults to UColorizedFoldersSettings::PrecomputedFolderIndex.
+ */
+UCLASS()
+class UColorizedFoldersCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UColorizedFoldersCommandlet();
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
@@ -141,15 +141,12 @@ private:
 
 		if (1) return 1;
 
-		const TArray<FColorizedFolderTheme> ThemeOptions = UColorizedFoldersManager::Get().GetThemes();
-		for (const auto& Theme : ThemeOptions)
+		const FString ThemeNameString = ThemeName.ToString();
+		if (UColorizedFoldersManager::Get().DoesThemeNameExist(ThemeNameString) && !CurrentActiveThemeDisplayName.Equals(ThemeNameString))
 		{
-			if (Theme.DisplayName.EqualTo(ThemeName) && !CurrentActiveThemeDisplayName.Equals(ThemeName.ToString()))
-			{
-				OutErrorMsg = FText::Format(LOCTEXT("RenameThemeAlreadyExists", "A theme already exists with the name '{0}'."), ThemeName);
-				EditableThemeName->SetError(OutErrorMsg);
-				return false;
-			}
+			OutErrorMsg = FText::Format(LOCTEXT("RenameThemeAlreadyExists", "A theme already exists with the name '{0}'."), ThemeName);
+			EditableThemeName->SetError(OutErrorMsg);
+			return false;
 		}
 
 		EditableThemeName->SetError(FText::GetEmpty());
@@ -354,17 +351,8 @@ void FColorizedFoldersDetailCustomization::RefreshComboBox()
 // validate theme name without error messages: 
 bool IsThemeNameValid(const FString& ThemeName)
 {
-	const TArray<FColorizedFolderTheme> ThemeOptions = UColorizedFoldersManager::Get().GetThemes();
-
-	for (const auto& Theme : ThemeOptions)
-	{
-		// show error message whenever there's duplicate (and different from the previous name) 
-		if (Theme.DisplayName.ToString().Equals(ThemeName))
-		{
-			return false;
-		}
-	}
-	return true;
+	// show error message whenever there's duplicate (and different from the previous name) 
+	return !UColorizedFoldersManager::Get().DoesThemeNameExist(ThemeName);
 }
 void GetThemeIdFromPath(FString& ThemePath, FString& ImportedThemeID)
 {
@@ -0,0 +1,169 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "ColorizedFoldersAppliedColors.h"
+
+#include "AssetViewUtils.h"
+#include "ColorizedFoldersStats.h"
+#include "ColorizedFoldersTrace.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Misc/ConfigCacheIni.h"
+
+namespace UE::ColorizedFolders::Private
+{
+	/** Widget type of the Content Browser, both in tabs and in the drawer. */
+	static const FName ContentBrowserWidgetType = TEXT("SContentBrowser");
+
+	/** Repaints every Content Browser below the widget, so their visible folders pick up the new colors. */
+	void RefreshContentBrowsers(const TSharedRef<SWidget>& InWidget)
+	{
+		if (InWidget->GetType() == ContentBrowserWidgetType)
+		{
+			InWidget->Invalidate(EInvalidateWidgetReason::Paint);
+			return;
+		}
+
+		FChildren* Children = InWidget->GetChildren();
+		for (int32 ChildIdx = 0; ChildIdx < Children->Num(); ++ChildIdx)
+		{
+			RefreshContentBrowsers(Children->GetChildAt(ChildIdx));
+		}
+	}
+
+	/** Repaints the live Content Browsers of all windows. */
+	void RefreshContentBrowsers(TConstArrayView<TSharedRef<SWindow>> InWindows)
+	{
+		for (const TSharedRef<SWindow>& Window : InWindows)
+		{
+			RefreshContentBrowsers(StaticCastSharedRef<SWidget>(Window));
+			RefreshContentBrowsers(Window->GetChildWindows());
+		}
+	}
+}
+
+namespace UE::ColorizedFolders
+{
+	void FColorizedFoldersAppliedColors::SetColor(const FString& InPath, const FLinearColor& InColor)
+	{
+		if (FAppliedColor* Existing = AppliedColors.Find(InPath))
+		{
+			Existing->Generation = CurrentGeneration;
+			if (Existing->Color == InColor)
+			{
+				return;
+			}
+
+			Existing->Color = InColor;
+		}
+		else
+		{
+			AppliedColors.Add(InPath, { InColor, CurrentGeneration });
+		}
+
+		WritePathColor(InPath, InColor);
+	}
+
+	void FColorizedFoldersAppliedColors::ClearColor(const FString& InPath)
+	{
+		if (AppliedColors.Remove(InPath) > 0)
+		{
+			WritePathColor(InPath, TOptional<FLinearColor>());
+		}
+	}
+
+	void FColorizedFoldersAppliedColors::SeedColor(const FString& InPath, const FLinearColor& InColor)
+	{
+		AppliedColors.Add(InPath, { InColor, CurrentGeneration });
+	}
+
+	void FColorizedFoldersAppliedColors::BeginFullUpdate()
+	{
+		++CurrentGeneration;
+	}
+
+	void FColorizedFoldersAppliedColors::EndFullUpdate()
+	{
+		COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::ClearStaleColors");
+
+		for (auto It = AppliedColors.CreateIterator(); It; ++It)
+		{
+			if (It.Value().Generation != CurrentGeneration)
+			{
+				WritePathColor(It.Key(), TOptional<FLinearColor>());
+				It.RemoveCurrent();
+			}
+		}
+
+		bFullUpdateInBatch |= WriteBatchDepth > 0;
+	}
+
+	void FColorizedFoldersAppliedColors::BeginWriteBatch()
+	{
+		++WriteBatchDepth;
+	}
+
+	void FColorizedFoldersAppliedColors::EndWriteBatch()
+	{
+		check(WriteBatchDepth > 0);
+		if (--WriteBatchDepth > 0)
+		{
+			return;
+		}
+
+		const bool bFullUpdate = bFullUpdateInBatch;
+		bFullUpdateInBatch = false;
+		if (PendingWrites.IsEmpty())
+		{
+			return;
+		}
+
+		COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::CommitColorWrites");
+
+		NumWrites += PendingWrites.Num();
+		if (bWritesEnabled)
+		{
+			INC_DWORD_STAT_BY(STAT_ColorizedFolders_PathColorWrites, PendingWrites.Num());
+
+			// SetPathColor only changes the config in memory and the Content Browser's color cache, nothing is written to disk yet
+			for (const TPair<FString, TOptional<FLinearColor>>& PendingWrite : PendingWrites)
+			{
+				AssetViewUtils::SetPathColor(PendingWrite.Key, PendingWrite.Value);
+			}
+
+			// Incremental updates are saved along with the rest of the config, full updates may rewrite a large part of the section
+			if (bFullUpdate)
+			{
+				COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::FlushConfig");
+				GConfig->Flush(false, GEditorPerProjectIni);
+			}
+
+			if (FSlateApplication::IsInitialized())
+			{
+				Private::RefreshContentBrowsers(FSlateApplication::Get().GetTopLevelWindows());
+			}
+		}
+		PendingWrites.Reset();
+	}
+
+	void FColorizedFoldersAppliedColors::WritePathColor(const FString& InPath, const TOptional<FLinearColor>& InColor)
+	{
+		// Only the last write of a folder counts, e.g. when a moved folder is cleared and colored again
+		if (WriteBatchDepth > 0)
+		{
+			PendingWrites.Add(InPath, InColor);
+			return;
+		}
+
+		CommitPathColor(InPath, InColor);
+	}
+
+	void FColorizedFoldersAppliedColors::CommitPathColor(const FString& InPath, const TOptional<FLinearColor>& InColor)
+	{
+		++NumWrites;
+		if (bWritesEnabled)
+		{
+			INC_DWORD_STAT(STAT_ColorizedFolders_PathColorWrites);
+			AssetViewUtils::SetPathColor(InPath, InColor);
+		}
+	}
+}
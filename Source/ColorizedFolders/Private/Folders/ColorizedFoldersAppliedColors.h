@@ -0,0 +1,102 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UE::ColorizedFolders
+{
+	/**
+	 * Remembers which colors the plugin has applied to which folders, so updates only write the difference.
+	 * Colors that are unchanged are skipped, and folders we colored before but that no longer match get cleared.
+	 * Folders that were never colored by the plugin are left untouched.
+	 * Writes inside a write batch are collected and committed together, see BeginWriteBatch().
+	 */
+	class FColorizedFoldersAppliedColors
+	{
+	public:
+		/** Applies a color to a folder, unless it's already the color we applied last time. */
+		void SetColor(const FString& InPath, const FLinearColor& InColor);
+
+		/** Clears the color of a folder, if it was previously applied by us. */
+		void ClearColor(const FString& InPath);
+
+		/** Remembers a color we applied in a previous session, without writing it again. */
+		void SeedColor(const FString& InPath, const FLinearColor& InColor);
+
+		/** Returns the color we applied to a folder, or nullptr. */
+		const FLinearColor* FindColor(const FString& InPath) const
+		{
+			const FAppliedColor* AppliedColor = AppliedColors.Find(InPath);
+			return AppliedColor ? &AppliedColor->Color : nullptr;
+		}
+
+		/**
+		 * Starts a full update. Every folder that gets a color before the matching EndFullUpdate() is kept,
+		 * all other previously applied colors are cleared by EndFullUpdate().
+		 */
+		void BeginFullUpdate();
+
+		/** Clears all colors that weren't re-applied since BeginFullUpdate(). */
+		void EndFullUpdate();
+
+		/**
+		 * Starts collecting color writes instead of writing every change right away. Batches can be nested.
+		 * The outermost EndWriteBatch() writes the final color of every changed folder once, and refreshes the Content Browser once.
+		 * The config is only flushed to disk if the batch contains a full update.
+		 */
+		void BeginWriteBatch();
+
+		/** Commits the collected color writes once the outermost batch ends. */
+		void EndWriteBatch();
+
+		/** Returns the number of folders currently colored by us. */
+		int32 Num() const
+		{
+			return AppliedColors.Num();
+		}
+
+		/** Disables writing to the Content Browser, e.g. for benchmarks. Changes are still tracked and counted. */
+		void SetWritesEnabled(bool bInWritesEnabled)
+		{
+			bWritesEnabled = bInWritesEnabled;
+		}
+
+		/**
+		 * Returns the number of folder colors written or cleared so far, including those skipped while writes are disabled.
+		 * Writes inside a batch are counted once it's committed, and only once per folder.
+		 */
+		uint64 GetNumWrites() const
+		{
+			return NumWrites;
+		}
+
+	private:
+		/** Writes or clears the color of a folder in the Content Browser, or adds it to the current batch. */
+		void WritePathColor(const FString& InPath, const TOptional<FLinearColor>& InColor);
+
+		/** Passes the color of a single folder on to the Content Browser, outside of a batch. */
+		void CommitPathColor(const FString& InPath, const TOptional<FLinearColor>& InColor);
+
+		struct FAppliedColor
+		{
+			FLinearColor Color;
+
+			/** The full update in which this color was last confirmed. */
+			uint32 Generation = 0;
+		};
+
+		TMap<FString, FAppliedColor> AppliedColors;
+		uint32 CurrentGeneration = 0;
+
+		/** Final color of every folder written during the current batch, an unset color clears the folder. */
+		TMap<FString, TOptional<FLinearColor>> PendingWrites;
+		int32 WriteBatchDepth = 0;
+
+		/** True if EndFullUpdate() has been called during the current batch. */
+		bool bFullUpdateInBatch = false;
+
+		uint64 NumWrites = 0;
+		bool bWritesEnabled = true;
+	};
+}
@@ -0,0 +1,344 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "ColorizedFoldersGlobAutomaton.h"
+
+#include "Algo/BinarySearch.h"
+#include "Algo/Unique.h"
+
+namespace UE::ColorizedFolders
+{
+	void FColorizedFoldersGlobAutomaton::Reset()
+	{
+		Patterns.Reset();
+		NfaStates.Reset();
+		ClassStarts.Reset();
+		FMemory::Memzero(AsciiClasses);
+		NumClasses = 1;
+		DfaTransitions.Reset();
+		DfaValues.Reset();
+		DfaStart = INDEX_NONE;
+		bUseNfa = false;
+	}
+
+	void FColorizedFoldersGlobAutomaton::AddPattern(FStringView InPattern, int32 InValue)
+	{
+		FPattern& Pattern = Patterns.AddDefaulted_GetRef();
+		Pattern.Value = InValue;
+
+		for (int32 CharIdx = 0; CharIdx < InPattern.Len(); ++CharIdx)
+		{
+			const TCHAR Char = InPattern[CharIdx];
+			if (Char == TEXT('*'))
+			{
+				// Consecutive stars match the same as a single one
+				if (Pattern.Elements.IsEmpty() || !Pattern.Elements.Last().bStar)
+				{
+					Pattern.Elements.AddDefaulted_GetRef().bStar = true;
+				}
+				continue;
+			}
+
+			FElement& Element = Pattern.Elements.AddDefaulted_GetRef();
+			if (Char == TEXT('?'))
+			{
+				// An empty negated set matches any character
+				Element.bNegated = true;
+				continue;
+			}
+
+			if (Char == TEXT('['))
+			{
+				int32 SetStart = CharIdx + 1;
+				const bool bNegated = SetStart < InPattern.Len() && (InPattern[SetStart] == TEXT('!') || InPattern[SetStart] == TEXT('^'));
+				SetStart += bNegated ? 1 : 0;
+
+				// A ']' right at the start is part of the set
+				int32 SetEnd = INDEX_NONE;
+				for (int32 EndIdx = SetStart + 1; EndIdx < InPattern.Len(); ++EndIdx)
+				{
+					if (InPattern[EndIdx] == TEXT(']'))
+					{
+						SetEnd = EndIdx;
+						break;
+					}
+				}
+
+				// Without a closing bracket the '[' is just a character
+				if (SetEnd != INDEX_NONE)
+				{
+					Element.bNegated = bNegated;
+					for (int32 SetIdx = SetStart; SetIdx < SetEnd; ++SetIdx)
+					{
+						TCHAR First = FChar::ToLower(InPattern[SetIdx]);
+						TCHAR Last = First;
+						if (SetIdx + 2 < SetEnd && InPattern[SetIdx + 1] == TEXT('-'))
+						{
+							Last = FChar::ToLower(InPattern[SetIdx + 2]);
+							SetIdx += 2;
+						}
+
+						if (Last < First)
+						{
+							Swap(First, Last);
+						}
+						Element.Ranges.Emplace(First, Last);
+					}
+
+					CharIdx = SetEnd;
+					continue;
+				}
+			}
+
+			const TCHAR LowerChar = FChar::ToLower(Char);
+			Element.Ranges.Emplace(LowerChar, LowerChar);
+		}
+	}
+
+	void FColorizedFoldersGlobAutomaton::Compile()
+	{
+		NfaStates.Reset();
+		ClassStarts.Reset();
+		DfaTransitions.Reset();
+		DfaValues.Reset();
+		DfaStart = INDEX_NONE;
+		bUseNfa = false;
+
+		for (int32 PatternIdx = 0; PatternIdx < Patterns.Num(); ++PatternIdx)
+		{
+			FPattern& Pattern = Patterns[PatternIdx];
+			Pattern.FirstState = NfaStates.Num();
+			for (int32 Position = 0; Position <= Pattern.Elements.Num(); ++Position)
+			{
+				NfaStates.Emplace(PatternIdx, Position);
+			}
+
+			// Every range boundary starts a new character class
+			for (const FElement& Element : Pattern.Elements)
+			{
+				for (const TPair<TCHAR, TCHAR>& Range : Element.Ranges)
+				{
+					ClassStarts.Add(Range.Key);
+					if (Range.Value < TNumericLimits<TCHAR>::Max())
+					{
+						ClassStarts.Add(Range.Value + 1);
+					}
+				}
+			}
+		}
+
+		ClassStarts.Sort();
+		ClassStarts.SetNum(Algo::Unique(ClassStarts));
+		NumClasses = ClassStarts.Num() + 1;
+
+		for (int32 Char = 0; Char < UE_ARRAY_COUNT(AsciiClasses); ++Char)
+		{
+			AsciiClasses[Char] = IntCastChecked<uint16>(Algo::UpperBound(ClassStarts, TCHAR(Char)));
+		}
+
+		if (Patterns.IsEmpty())
+		{
+			return;
+		}
+
+		bUseNfa = !BuildDfa();
+		if (bUseNfa)
+		{
+			DfaTransitions.Empty();
+			DfaValues.Empty();
+		}
+	}
+
+	int32 FColorizedFoldersGlobAutomaton::Match(FStringView InName) const
+	{
+		if (Patterns.IsEmpty())
+		{
+			return INDEX_NONE;
+		}
+
+		if (!bUseNfa)
+		{
+			int32 State = DfaStart;
+			for (const TCHAR Char : InName)
+			{
+				State = DfaTransitions[State * NumClasses + GetCharClass(FChar::ToLower(Char))];
+				if (State == INDEX_NONE)
+				{
+					return INDEX_NONE;
+				}
+			}
+			return DfaValues[State];
+		}
+
+		TBitArray<> Visited(false, NfaStates.Num());
+		TArray<int32, TInlineAllocator<64>> States;
+		for (const FPattern& Pattern : Patterns)
+		{
+			AddState(Pattern.FirstState, States, Visited);
+		}
+		for (const int32 State : States)
+		{
+			Visited[State] = false;
+		}
+
+		TArray<int32, TInlineAllocator<64>> NextStates;
+		for (const TCHAR Char : InName)
+		{
+			NextStates.Reset();
+			Step(States, FChar::ToLower(Char), NextStates, Visited);
+			if (NextStates.IsEmpty())
+			{
+				return INDEX_NONE;
+			}
+			Swap(States, NextStates);
+		}
+
+		return GetAcceptedValue(States);
+	}
+
+	template <typename AllocatorType>
+	void FColorizedFoldersGlobAutomaton::AddState(int32 InState, TArray<int32, AllocatorType>& OutStates, TBitArray<>& Visited) const
+	{
+		for (;;)
+		{
+			if (Visited[InState])
+			{
+				return;
+			}
+			Visited[InState] = true;
+			OutStates.Add(InState);
+
+			// A star may also match nothing, so the state after it is reached right away
+			const TPair<int32, int32>& NfaState = NfaStates[InState];
+			const FPattern& Pattern = Patterns[NfaState.Key];
+			if (NfaState.Value >= Pattern.Elements.Num() || !Pattern.Elements[NfaState.Value].bStar)
+			{
+				return;
+			}
+			++InState;
+		}
+	}
+
+	template <typename InAllocatorType, typename OutAllocatorType>
+	void FColorizedFoldersGlobAutomaton::Step(const TArray<int32, InAllocatorType>& InStates, TCHAR InChar, TArray<int32, OutAllocatorType>& OutStates, TBitArray<>& Visited) const
+	{
+		for (const int32 State : InStates)
+		{
+			const TPair<int32, int32>& NfaState = NfaStates[State];
+			const FPattern& Pattern = Patterns[NfaState.Key];
+			if (NfaState.Value >= Pattern.Elements.Num())
+			{
+				continue;
+			}
+
+			const FElement& Element = Pattern.Elements[NfaState.Value];
+			if (Element.bStar)
+			{
+				AddState(State, OutStates, Visited);
+			}
+			else if (Element.Matches(InChar))
+			{
+				AddState(State + 1, OutStates, Visited);
+			}
+		}
+
+		for (const int32 State : OutStates)
+		{
+			Visited[State] = false;
+		}
+	}
+
+	template <typename AllocatorType>
+	int32 FColorizedFoldersGlobAutomaton::GetAcceptedValue(const TArray<int32, AllocatorType>& InStates) const
+	{
+		int32 Value = INDEX_NONE;
+		for (const int32 State : InStates)
+		{
+			const TPair<int32, int32>& NfaState = NfaStates[State];
+			const FPattern& Pattern = Patterns[NfaState.Key];
+			if (NfaState.Value == Pattern.Elements.Num())
+			{
+				Value = FMath::Max(Value, Pattern.Value);
+			}
+		}
+		return Value;
+	}
+
+	int32 FColorizedFoldersGlobAutomaton::GetCharClass(TCHAR InChar) const
+	{
+		if (static_cast<uint32>(InChar) < UE_ARRAY_COUNT(AsciiClasses))
+		{
+			return AsciiClasses[InChar];
+		}
+		return Algo::UpperBound(ClassStarts, InChar);
+	}
+
+	bool FColorizedFoldersGlobAutomaton::BuildDfa()
+	{
+		// Each DFA state is the set of NFA states that can be active at the same time (subset construction)
+		TArray<TArray<int32>> DfaStateSets;
+		TMultiMap<uint32, int32> HashToDfaState;
+		TBitArray<> Visited(false, NfaStates.Num());
+
+		auto FindOrAddDfaState = [this, &DfaStateSets, &HashToDfaState](TArray<int32>& InStates)
+		{
+			if (InStates.IsEmpty())
+			{
+				return INDEX_NONE;
+			}
+
+			InStates.Sort();
+			uint32 Hash = 0;
+			for (const int32 State : InStates)
+			{
+				Hash = HashCombineFast(Hash, ::GetTypeHash(State));
+			}
+
+			for (auto It = HashToDfaState.CreateConstKeyIterator(Hash); It; ++It)
+			{
+				if (DfaStateSets[It.Value()] == InStates)
+				{
+					return It.Value();
+				}
+			}
+
+			const int32 NewState = DfaStateSets.Add(InStates);
+			HashToDfaState.Add(Hash, NewState);
+			DfaValues.Add(GetAcceptedValue(InStates));
+			return NewState;
+		};
+
+		TArray<int32> States;
+		for (const FPattern& Pattern : Patterns)
+		{
+			AddState(Pattern.FirstState, States, Visited);
+		}
+		for (const int32 State : States)
+		{
+			Visited[State] = false;
+		}
+		DfaStart = FindOrAddDfaState(States);
+
+		// New states are appended, so this visits every state exactly once
+		for (int32 DfaState = 0; DfaState < DfaStateSets.Num(); ++DfaState)
+		{
+			if (DfaStateSets.Num() > MaxDfaStates)
+			{
+				return false;
+			}
+
+			DfaTransitions.SetNumUninitialized((DfaState + 1) * NumClasses);
+			for (int32 CharClass = 0; CharClass < NumClasses; ++CharClass)
+			{
+				// All characters of a class behave the same, so its first character stands in for all of them
+				const TCHAR ClassChar = CharClass > 0 ? ClassStarts[CharClass - 1] : TCHAR(0);
+
+				States.Reset();
+				Step(DfaStateSets[DfaState], ClassChar, States, Visited);
+				DfaTransitions[DfaState * NumClasses + CharClass] = FindOrAddDfaState(States);
+			}
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,139 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UE::ColorizedFolders
+{
+	/**
+	 * Glob patterns of all schemes compiled into a single automaton, which classifies a folder name in one pass over
+	 * its characters, no matter how many patterns there are. Matching is case-insensitive and covers the whole name.
+	 *
+	 * Supported syntax:
+	 *  - '*' matches any number of characters.
+	 *  - '?' matches a single character.
+	 *  - '[...]' matches a single character of a set, e.g. "[abc]" or "[a-z]". A leading '!' or '^' negates the set.
+	 *
+	 * All patterns are turned into a DFA when compiling. Should that take more than MaxDfaStates states, which only
+	 * pathological combinations of many stars do, the automaton keeps simulating the NFA instead.
+	 */
+	class FColorizedFoldersGlobAutomaton
+	{
+	public:
+		/** Maximum number of DFA states before falling back to the NFA. */
+		static constexpr int32 MaxDfaStates = 4096;
+
+		/** Returns true if the string uses any glob syntax. */
+		static bool IsPattern(FStringView InString)
+		{
+			for (const TCHAR Char : InString)
+			{
+				if (Char == TEXT('*') || Char == TEXT('?') || Char == TEXT('['))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/** Removes all patterns. */
+		void Reset();
+
+		/** Adds a pattern, which only takes effect once Compile() has been called. If several patterns match, the highest value wins. */
+		void AddPattern(FStringView InPattern, int32 InValue);
+
+		/** Builds the automaton from all patterns added so far. */
+		void Compile();
+
+		/** Returns the highest value of all patterns matching the name, or INDEX_NONE. Safe to call from any thread. */
+		int32 Match(FStringView InName) const;
+
+		/** Returns true if no patterns have been added. */
+		bool IsEmpty() const
+		{
+			return Patterns.IsEmpty();
+		}
+
+		/** Returns true if the patterns were too complex to be turned into a DFA. */
+		bool IsUsingNfa() const
+		{
+			return bUseNfa;
+		}
+
+	private:
+		/** A single position of a pattern, either a set of characters or a star. */
+		struct FElement
+		{
+			/** Inclusive character ranges, in lowercase. */
+			TArray<TPair<TCHAR, TCHAR>, TInlineAllocator<1>> Ranges;
+
+			bool bNegated = false;
+			bool bStar = false;
+
+			bool Matches(TCHAR InChar) const
+			{
+				for (const TPair<TCHAR, TCHAR>& Range : Ranges)
+				{
+					if (InChar >= Range.Key && InChar <= Range.Value)
+					{
+						return !bNegated;
+					}
+				}
+				return bNegated;
+			}
+		};
+
+		struct FPattern
+		{
+			TArray<FElement> Elements;
+			int32 Value = INDEX_NONE;
+
+			/** NFA state before the first element. The state after element N is FirstState + N + 1. */
+			int32 FirstState = 0;
+		};
+
+		/** Adds an NFA state along with all states it reaches by skipping stars. */
+		template <typename AllocatorType>
+		void AddState(int32 InState, TArray<int32, AllocatorType>& OutStates, TBitArray<>& Visited) const;
+
+		/** Advances a set of NFA states by a lowercase character. */
+		template <typename InAllocatorType, typename OutAllocatorType>
+		void Step(const TArray<int32, InAllocatorType>& InStates, TCHAR InChar, TArray<int32, OutAllocatorType>& OutStates, TBitArray<>& Visited) const;
+
+		/** Returns the highest value of all accepting states in the set, or INDEX_NONE. */
+		template <typename AllocatorType>
+		int32 GetAcceptedValue(const TArray<int32, AllocatorType>& InStates) const;
+
+		/** Returns the character class of a lowercase character. */
+		int32 GetCharClass(TCHAR InChar) const;
+
+		bool BuildDfa();
+
+		TArray<FPattern> Patterns;
+
+		/** Pattern of each NFA state, and the number of elements consumed to get there. */
+		TArray<TPair<int32, int32>> NfaStates;
+
+		/**
+		 * Sorted characters at which a new character class starts. All characters of a class are treated the same by
+		 * every pattern, so the DFA only needs one transition per class instead of one per character.
+		 */
+		TArray<TCHAR> ClassStarts;
+
+		/** Character class of every ASCII character, which is what almost all folder names consist of. */
+		uint16 AsciiClasses[128] = {};
+
+		int32 NumClasses = 1;
+
+		/** Next state for each state and character class, INDEX_NONE once no pattern can match anymore. */
+		TArray<int32> DfaTransitions;
+
+		/** Highest accepted value of each DFA state, or INDEX_NONE. */
+		TArray<int32> DfaValues;
+
+		int32 DfaStart = INDEX_NONE;
+
+		bool bUseNfa = false;
+	};
+}
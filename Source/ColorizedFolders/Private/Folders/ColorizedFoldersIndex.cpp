@@ -0,0 +1,272 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "ColorizedFoldersIndex.h"
+
+namespace UE::ColorizedFolders
+{
+	void FColorizedFoldersIndex::Reset()
+	{
+		Nodes.Empty();
+		PathToNode.Empty();
+		DirtyNodes.Empty();
+		RemovedPaths.Empty();
+	}
+
+	int32 FColorizedFoldersIndex::AddFolder(const FString& InPath)
+	{
+		const int32 NodeIndex = FindOrAddNode(InPath);
+		Nodes[NodeIndex].bExplicit = true;
+		MarkNodeDirty(NodeIndex);
+		return NodeIndex;
+	}
+
+	void FColorizedFoldersIndex::RemoveFolder(const FString& InPath)
+	{
+		const int32* NodeIndex = PathToNode.Find(InPath);
+		if (NodeIndex == nullptr)
+		{
+			return;
+		}
+
+		const int32 RemovedIndex = *NodeIndex;
+		const int32 ParentIndex = Nodes[RemovedIndex].Parent;
+		if (ParentIndex != INDEX_NONE)
+		{
+			Nodes[ParentIndex].Children.RemoveSingleSwap(RemovedIndex);
+		}
+
+		RemoveSubtree(RemovedIndex);
+	}
+
+	void FColorizedFoldersIndex::MoveFolder(const FString& InOldPath, const FString& InNewPath)
+	{
+		const int32* NodeIndexPtr = PathToNode.Find(InOldPath);
+		if (NodeIndexPtr == nullptr)
+		{
+			// We never knew about the old folder, so just treat it as a new one
+			AddFolder(InNewPath);
+			return;
+		}
+
+		if (const int32* ExistingIndex = PathToNode.Find(InNewPath))
+		{
+			// Merging into an existing folder, so move the children over instead of waiting for them to be reported again
+			const int32 TargetIndex = *ExistingIndex;
+			MergeSubtree(*NodeIndexPtr, TargetIndex);
+			Nodes[TargetIndex].bExplicit = true;
+			return;
+		}
+
+		const int32 NodeIndex = *NodeIndexPtr;
+
+		// Detach from the old parent
+		const int32 OldParent = Nodes[NodeIndex].Parent;
+		if (OldParent != INDEX_NONE)
+		{
+			Nodes[OldParent].Children.RemoveSingleSwap(NodeIndex);
+		}
+
+		// Attach to the new parent
+		int32 SlashIdx = INDEX_NONE;
+		InNewPath.FindLastChar(TEXT('/'), SlashIdx);
+		const int32 NewParent = SlashIdx > 0 ? FindOrAddNode(InNewPath.Left(SlashIdx)) : INDEX_NONE;
+		Nodes[NodeIndex].Parent = NewParent;
+		if (NewParent != INDEX_NONE)
+		{
+			Nodes[NewParent].Children.Add(NodeIndex);
+		}
+
+		Nodes[NodeIndex].bExplicit = true;
+		RebaseSubtree(NodeIndex, InOldPath.Len(), InNewPath);
+	}
+
+	void FColorizedFoldersIndex::ApplyDelta(const FColorizedFoldersDelta& InDelta)
+	{
+		switch (InDelta.Change)
+		{
+		case EColorizedFoldersChange::Added:
+			AddFolder(InDelta.Path);
+			break;
+
+		case EColorizedFoldersChange::Modified:
+			MarkFolderDirty(InDelta.Path);
+			break;
+
+		case EColorizedFoldersChange::Moved:
+			MoveFolder(InDelta.PreviousPath, InDelta.Path);
+			break;
+
+		case EColorizedFoldersChange::Removed:
+			RemoveFolder(InDelta.Path);
+			break;
+		}
+	}
+
+	void FColorizedFoldersIndex::MarkFolderDirty(const FString& InPath)
+	{
+		if (const int32* NodeIndex = PathToNode.Find(InPath))
+		{
+			MarkNodeDirty(*NodeIndex);
+		}
+	}
+
+	void FColorizedFoldersIndex::MarkAllDirty()
+	{
+		for (auto It = Nodes.CreateIterator(); It; ++It)
+		{
+			MarkNodeDirty(It.GetIndex());
+		}
+	}
+
+	void FColorizedFoldersIndex::ConsumeDirtyNodes(TArray<int32>& OutDirtyNodes)
+	{
+		OutDirtyNodes.Reserve(OutDirtyNodes.Num() + DirtyNodes.Num());
+		for (const int32 NodeIndex : DirtyNodes)
+		{
+			// Nodes may have been removed (or even reused) since they were marked dirty
+			if (!Nodes.IsValidIndex(NodeIndex) || !Nodes[NodeIndex].bDirty)
+			{
+				continue;
+			}
+
+			FNode& Node = Nodes[NodeIndex];
+			Node.bDirty = false;
+			if (Node.bExplicit)
+			{
+				OutDirtyNodes.Add(NodeIndex);
+			}
+		}
+		DirtyNodes.Reset();
+	}
+
+	void FColorizedFoldersIndex::ClearDirtyFolders()
+	{
+		for (const int32 NodeIndex : DirtyNodes)
+		{
+			if (Nodes.IsValidIndex(NodeIndex))
+			{
+				Nodes[NodeIndex].bDirty = false;
+			}
+		}
+		DirtyNodes.Reset();
+	}
+
+	void FColorizedFoldersIndex::ConsumeRemovedFolders(TArray<FString>& OutRemovedPaths)
+	{
+		OutRemovedPaths.Append(MoveTemp(RemovedPaths));
+		RemovedPaths.Reset();
+	}
+
+	void FColorizedFoldersIndex::GetRootNodes(TArray<int32>& OutRootNodes) const
+	{
+		for (auto It = Nodes.CreateConstIterator(); It; ++It)
+		{
+			if (It->Parent == INDEX_NONE)
+			{
+				OutRootNodes.Add(It.GetIndex());
+			}
+		}
+	}
+
+	int32 FColorizedFoldersIndex::FindOrAddNode(const FString& InPath)
+	{
+		if (const int32* Existing = PathToNode.Find(InPath))
+		{
+			return *Existing;
+		}
+
+		// Make sure the parent exists first, mount roots (e.g. "/Game") don't have one
+		int32 SlashIdx = INDEX_NONE;
+		InPath.FindLastChar(TEXT('/'), SlashIdx);
+		const int32 ParentIndex = SlashIdx > 0 ? FindOrAddNode(InPath.Left(SlashIdx)) : INDEX_NONE;
+
+		FNode NewNode;
+		NewNode.Path = InPath;
+		NewNode.Parent = ParentIndex;
+
+		const int32 NodeIndex = Nodes.Add(MoveTemp(NewNode));
+		PathToNode.Add(InPath, NodeIndex);
+		if (ParentIndex != INDEX_NONE)
+		{
+			Nodes[ParentIndex].Children.Add(NodeIndex);
+		}
+
+		return NodeIndex;
+	}
+
+	void FColorizedFoldersIndex::MarkNodeDirty(int32 NodeIndex)
+	{
+		FNode& Node = Nodes[NodeIndex];
+		if (!Node.bDirty)
+		{
+			Node.bDirty = true;
+			DirtyNodes.Add(NodeIndex);
+		}
+	}
+
+	void FColorizedFoldersIndex::RemoveSubtree(int32 NodeIndex)
+	{
+		for (const int32 ChildIndex : Nodes[NodeIndex].Children)
+		{
+			RemoveSubtree(ChildIndex);
+		}
+
+		PathToNode.Remove(Nodes[NodeIndex].Path);
+		RemovedPaths.Add(MoveTemp(Nodes[NodeIndex].Path));
+		Nodes.RemoveAt(NodeIndex);
+	}
+
+	void FColorizedFoldersIndex::MergeSubtree(int32 SourceIndex, int32 TargetIndex)
+	{
+		const TArray<int32> SourceChildren = MoveTemp(Nodes[SourceIndex].Children);
+		for (const int32 ChildIndex : SourceChildren)
+		{
+			FString NewChildPath = Nodes[TargetIndex].Path;
+			NewChildPath += TEXT('/');
+			NewChildPath += Nodes[ChildIndex].GetLeafName();
+
+			if (const int32* ExistingChild = PathToNode.Find(NewChildPath))
+			{
+				// Both folders have a child of the same name, which are merged the same way
+				MergeSubtree(ChildIndex, *ExistingChild);
+			}
+			else
+			{
+				const int32 OldPrefixLen = Nodes[ChildIndex].Path.Len();
+				Nodes[ChildIndex].Parent = TargetIndex;
+				Nodes[TargetIndex].Children.Add(ChildIndex);
+				RebaseSubtree(ChildIndex, OldPrefixLen, NewChildPath);
+			}
+		}
+
+		// Only the now empty source folder is left, which is gone after the merge
+		FNode& Source = Nodes[SourceIndex];
+		if (Source.Parent != INDEX_NONE)
+		{
+			Nodes[Source.Parent].Children.RemoveSingleSwap(SourceIndex);
+		}
+		Nodes[TargetIndex].bExplicit |= Source.bExplicit;
+
+		PathToNode.Remove(Source.Path);
+		RemovedPaths.Add(MoveTemp(Source.Path));
+		Nodes.RemoveAt(SourceIndex);
+
+		MarkNodeDirty(TargetIndex);
+	}
+
+	void FColorizedFoldersIndex::RebaseSubtree(int32 NodeIndex, int32 OldPrefixLen, const FString& NewPrefix)
+	{
+		FNode& Node = Nodes[NodeIndex];
+		PathToNode.Remove(Node.Path);
+		RemovedPaths.Add(Node.Path);
+		Node.Path = NewPrefix + Node.Path.RightChop(OldPrefixLen);
+		PathToNode.Add(Node.Path, NodeIndex);
+		MarkNodeDirty(NodeIndex);
+
+		for (const int32 ChildIndex : Node.Children)
+		{
+			RebaseSubtree(ChildIndex, OldPrefixLen, NewPrefix);
+		}
+	}
+}
@@ -0,0 +1,160 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UE::ColorizedFolders
+{
+	/** Kind of change reported for a folder. */
+	enum class EColorizedFoldersChange : uint8
+	{
+		Added,
+		Modified,
+		Moved,
+		Removed,
+	};
+
+	/** A single folder change, e.g. from the Content Browser. */
+	struct FColorizedFoldersDelta
+	{
+		EColorizedFoldersChange Change = EColorizedFoldersChange::Added;
+
+		/** Package path of the folder. */
+		FString Path;
+
+		/** Package path of the folder before it was moved. Only used by EColorizedFoldersChange::Moved. */
+		FString PreviousPath;
+	};
+
+	/**
+	 * Persistent in-memory tree of all known content folders, keyed by their package path (e.g. "/Game/Characters").
+	 * Content Browser deltas are applied directly to the tree and only the touched folders are marked dirty,
+	 * so re-evaluating folder colors scales with the size of the change rather than the size of the project.
+	 */
+	class FColorizedFoldersIndex
+	{
+	public:
+		/** A single folder in the index. */
+		struct FNode
+		{
+			/** Full package path of the folder, without a trailing slash. */
+			FString Path;
+
+			/** Index of the parent folder, or INDEX_NONE for mount roots. */
+			int32 Parent = INDEX_NONE;
+
+			/** Indices of the direct child folders. */
+			TArray<int32> Children;
+
+			/** False for folders that are only known as the ancestor of another folder, e.g. mount roots. */
+			bool bExplicit = false;
+
+			/** True if the folder has to be re-evaluated during the next update. */
+			bool bDirty = false;
+
+			/** Scheme the folder matched itself as of its last evaluation, not counting schemes inherited from its parents. */
+			int32 SchemeIndex = INDEX_NONE;
+
+			/** Returns the last path segment of this folder. */
+			FStringView GetLeafName() const
+			{
+				int32 SlashIdx = INDEX_NONE;
+				Path.FindLastChar(TEXT('/'), SlashIdx);
+				return FStringView(Path).RightChop(SlashIdx + 1);
+			}
+		};
+
+		/** Removes all folders from the index. */
+		void Reset();
+
+		/** Adds a folder and any missing ancestors to the index, marking it dirty. Returns the node of the folder. */
+		int32 AddFolder(const FString& InPath);
+
+		/** Removes a folder and its whole subtree from the index. */
+		void RemoveFolder(const FString& InPath);
+
+		/**
+		 * Moves a folder and its whole subtree to a new path, marking all moved folders dirty.
+		 * If the new path exists already, the subtree is merged into it.
+		 */
+		void MoveFolder(const FString& InOldPath, const FString& InNewPath);
+
+		/** Applies a single folder change to the index. */
+		void ApplyDelta(const FColorizedFoldersDelta& InDelta);
+
+		/** Marks a single folder dirty, so it is re-evaluated during the next update. */
+		void MarkFolderDirty(const FString& InPath);
+
+		/** Marks every folder in the index dirty. */
+		void MarkAllDirty();
+
+		/** Returns the nodes of all dirty folders and clears their dirty state. */
+		void ConsumeDirtyNodes(TArray<int32>& OutDirtyNodes);
+
+		/** Clears the dirty state of all folders, e.g. because they have just been evaluated elsewhere. */
+		void ClearDirtyFolders();
+
+		/** Returns the paths of all folders that were removed or moved away since the last call. */
+		void ConsumeRemovedFolders(TArray<FString>& OutRemovedPaths);
+
+		/** Returns whether the folder has been added to the index, implicit ancestors like mount roots don't count. */
+		bool Contains(const FString& InPath) const
+		{
+			const int32* NodeIndex = PathToNode.Find(InPath);
+			return NodeIndex && Nodes[*NodeIndex].bExplicit;
+		}
+
+		/** Returns whether the path is known to the index at all, including implicit ancestors. */
+		bool ContainsNode(const FString& InPath) const
+		{
+			return PathToNode.Contains(InPath);
+		}
+
+		/** Returns the number of folders in the index, including implicit ancestors. */
+		int32 Num() const
+		{
+			return Nodes.Num();
+		}
+
+		/** Returns an upper bound of all node indices, e.g. to size per-node bit arrays. */
+		int32 GetMaxNodeIndex() const
+		{
+			return Nodes.GetMaxIndex();
+		}
+
+		/** Returns whether a node index below GetMaxNodeIndex() refers to a folder in the index. */
+		bool IsValidNode(int32 InNodeIndex) const
+		{
+			return Nodes.IsValidIndex(InNodeIndex);
+		}
+
+		const FNode& GetNode(int32 InNodeIndex) const
+		{
+			return Nodes[InNodeIndex];
+		}
+
+		/** Remembers the scheme a folder matched itself. */
+		void SetSchemeIndex(int32 InNodeIndex, int32 InSchemeIndex)
+		{
+			Nodes[InNodeIndex].SchemeIndex = InSchemeIndex;
+		}
+
+		/** Returns the nodes without parent, i.e. the mount roots. */
+		void GetRootNodes(TArray<int32>& OutRootNodes) const;
+
+	private:
+		int32 FindOrAddNode(const FString& InPath);
+		void MarkNodeDirty(int32 NodeIndex);
+		void RemoveSubtree(int32 NodeIndex);
+
+		/** Moves the children of a folder below another one, merging children of the same name, and removes the folder. */
+		void MergeSubtree(int32 SourceIndex, int32 TargetIndex);
+		void RebaseSubtree(int32 NodeIndex, int32 OldPrefixLen, const FString& NewPrefix);
+
+		TSparseArray<FNode> Nodes;
+		TMap<FString, int32> PathToNode;
+		TArray<int32> DirtyNodes;
+		TArray<FString> RemovedPaths;
+	};
+}
@@ -0,0 +1,254 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "ColorizedFoldersIndexCache.h"
+
+#include "ColorizedFoldersAppliedColors.h"
+#include "ColorizedFoldersScanner.h"
+#include "HAL/FileManager.h"
+#include "Misc/PathViews.h"
+#include "Misc/Paths.h"
+
+namespace UE::ColorizedFolders::Private
+{
+	/** "CFIX" */
+	constexpr uint32 IndexCacheMagic = 0x58494643;
+
+	/** Bump whenever the layout of the cache file changes, older caches are discarded. */
+	constexpr uint32 IndexCacheVersion = 3;
+
+	enum class ECachedDirFlags : uint8
+	{
+		None = 0,
+		Root = 1 << 0,
+		HasColor = 1 << 1,
+		HasScheme = 1 << 2,
+	};
+	ENUM_CLASS_FLAGS(ECachedDirFlags);
+}
+
+namespace UE::ColorizedFolders
+{
+	FString FColorizedFoldersIndexCache::GetDefaultFilename()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("ColorizedFolders") / TEXT("FolderIndex.bin");
+	}
+
+	FString FColorizedFoldersIndexCache::GetPrecomputedFilename()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("ColorizedFolders") / TEXT("PrecomputedFolderIndex.bin");
+	}
+
+	void FColorizedFoldersIndexCache::Build(const FColorizedFoldersScanResult& InScanResult, const FColorizedFoldersAppliedColors& InAppliedColors)
+	{
+		Dirs.Reset(InScanResult.Roots.Num() + InScanResult.Dirs.Num());
+
+		for (int32 RootIdx = 0; RootIdx < InScanResult.Roots.Num(); ++RootIdx)
+		{
+			FColorizedFoldersCachedDir& CachedDir = Dirs.AddDefaulted_GetRef();
+			CachedDir.Path = InScanResult.Roots[RootIdx];
+			CachedDir.Timestamp = InScanResult.RootTimestamps[RootIdx];
+			CachedDir.bIsRoot = true;
+		}
+
+		for (int32 DirIdx = 0; DirIdx < InScanResult.Dirs.Num(); ++DirIdx)
+		{
+			FColorizedFoldersCachedDir& CachedDir = Dirs.AddDefaulted_GetRef();
+			CachedDir.Path = InScanResult.Dirs[DirIdx];
+			CachedDir.Timestamp = InScanResult.Timestamps.IsValidIndex(DirIdx) ? InScanResult.Timestamps[DirIdx] : FDateTime::MinValue();
+			CachedDir.SchemeIndex = InScanResult.SchemeIndices.IsValidIndex(DirIdx) ? InScanResult.SchemeIndices[DirIdx] : INDEX_NONE;
+			if (const FLinearColor* Color = InAppliedColors.FindColor(CachedDir.Path))
+			{
+				CachedDir.Color = *Color;
+			}
+		}
+
+		BuildLookups();
+	}
+
+	void FColorizedFoldersIndexCache::UpdateColors(const FColorizedFoldersAppliedColors& InAppliedColors)
+	{
+		for (FColorizedFoldersCachedDir& CachedDir : Dirs)
+		{
+			const FLinearColor* Color = CachedDir.bIsRoot ? nullptr : InAppliedColors.FindColor(CachedDir.Path);
+			CachedDir.Color = Color ? *Color : TOptional<FLinearColor>();
+		}
+	}
+
+	bool FColorizedFoldersIndexCache::Load(const FString& InFilename)
+	{
+		using namespace Private;
+
+		Dirs.Reset();
+		PathToDir.Reset();
+		ThemeId.Invalidate();
+		SchemesHash = 0;
+		PrecomputedTimestamp = FDateTime::MinValue();
+
+		const TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*InFilename, FILEREAD_Silent));
+		if (!Ar)
+		{
+			return false;
+		}
+
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		int32 NumDirs = 0;
+		*Ar << Magic << Version;
+		if (Ar->IsError() || Magic != IndexCacheMagic || Version != IndexCacheVersion)
+		{
+			return false;
+		}
+
+		int64 PrecomputedTicks = 0;
+		*Ar << ThemeId << SchemesHash << PrecomputedTicks << NumDirs;
+		if (Ar->IsError() || NumDirs < 0)
+		{
+			return false;
+		}
+		PrecomputedTimestamp = FDateTime(PrecomputedTicks);
+
+		// Folders are stored by their name relative to the parent, which always comes first
+		Dirs.Reserve(NumDirs);
+		for (int32 DirIdx = 0; DirIdx < NumDirs && !Ar->IsError(); ++DirIdx)
+		{
+			int32 ParentIdx = INDEX_NONE;
+			FString Name;
+			int64 Ticks = 0;
+			ECachedDirFlags Flags = ECachedDirFlags::None;
+			*Ar << ParentIdx << Name << Ticks << Flags;
+
+			FColorizedFoldersCachedDir& CachedDir = Dirs.AddDefaulted_GetRef();
+			if (ParentIdx == INDEX_NONE)
+			{
+				CachedDir.Path = MoveTemp(Name);
+			}
+			else if (ParentIdx >= 0 && ParentIdx < DirIdx)
+			{
+				CachedDir.Path = Dirs[ParentIdx].Path / Name;
+			}
+			else
+			{
+				Ar->SetError();
+				break;
+			}
+
+			CachedDir.Timestamp = FDateTime(Ticks);
+			CachedDir.bIsRoot = EnumHasAnyFlags(Flags, ECachedDirFlags::Root);
+			if (EnumHasAnyFlags(Flags, ECachedDirFlags::HasColor))
+			{
+				FLinearColor Color;
+				*Ar << Color;
+				CachedDir.Color = Color;
+			}
+			if (EnumHasAnyFlags(Flags, ECachedDirFlags::HasScheme))
+			{
+				*Ar << CachedDir.SchemeIndex;
+			}
+		}
+
+		if (Ar->IsError() || !Ar->Close())
+		{
+			Dirs.Reset();
+			return false;
+		}
+
+		BuildLookups();
+		return true;
+	}
+
+	bool FColorizedFoldersIndexCache::Save(const FString& InFilename) const
+	{
+		using namespace Private;
+
+		// Write to a temporary file first, so a crash while saving can't leave a broken cache behind
+		const FString TempFilename = FString::Printf(TEXT("%s.%s.tmp"), *InFilename, *FGuid::NewGuid().ToString());
+		{
+			const TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*TempFilename, FILEWRITE_Silent));
+			if (!Ar)
+			{
+				return false;
+			}
+
+			uint32 Magic = IndexCacheMagic;
+			uint32 Version = IndexCacheVersion;
+			FGuid SavedThemeId = ThemeId;
+			uint32 SavedSchemesHash = SchemesHash;
+			int64 PrecomputedTicks = PrecomputedTimestamp.GetTicks();
+			int32 NumDirs = Dirs.Num();
+			*Ar << Magic << Version << SavedThemeId << SavedSchemesHash << PrecomputedTicks << NumDirs;
+
+			for (int32 DirIdx = 0; DirIdx < Dirs.Num(); ++DirIdx)
+			{
+				const FColorizedFoldersCachedDir& CachedDir = Dirs[DirIdx];
+
+				const FStringView ParentPath = FPathViews::GetPath(CachedDir.Path);
+				const int32* ParentIdxPtr = CachedDir.bIsRoot ? nullptr : PathToDir.FindByHash(GetTypeHash(ParentPath), ParentPath);
+				int32 ParentIdx = ParentIdxPtr ? *ParentIdxPtr : INDEX_NONE;
+				FString Name = ParentIdxPtr ? FString(FPathViews::GetCleanFilename(CachedDir.Path)) : CachedDir.Path;
+				int64 Ticks = CachedDir.Timestamp.GetTicks();
+
+				ECachedDirFlags Flags = ECachedDirFlags::None;
+				if (CachedDir.bIsRoot)
+				{
+					Flags |= ECachedDirFlags::Root;
+				}
+				if (CachedDir.Color.IsSet())
+				{
+					Flags |= ECachedDirFlags::HasColor;
+				}
+				if (CachedDir.SchemeIndex != INDEX_NONE)
+				{
+					Flags |= ECachedDirFlags::HasScheme;
+				}
+
+				*Ar << ParentIdx << Name << Ticks << Flags;
+				if (CachedDir.Color.IsSet())
+				{
+					FLinearColor Color = CachedDir.Color.GetValue();
+					*Ar << Color;
+				}
+				if (CachedDir.SchemeIndex != INDEX_NONE)
+				{
+					int32 SchemeIndex = CachedDir.SchemeIndex;
+					*Ar << SchemeIndex;
+				}
+			}
+
+			if (!Ar->Close())
+			{
+				IFileManager::Get().Delete(*TempFilename, false, false, true);
+				return false;
+			}
+		}
+
+		return IFileManager::Get().Move(*InFilename, *TempFilename, true, true, false, true);
+	}
+
+	void FColorizedFoldersIndexCache::BuildLookups()
+	{
+		// Sorting by path puts every parent in front of its children
+		Dirs.Sort([](const FColorizedFoldersCachedDir& A, const FColorizedFoldersCachedDir& B)
+		{
+			return A.Path.Compare(B.Path, ESearchCase::IgnoreCase) < 0;
+		});
+
+		PathToDir.Reset();
+		PathToDir.Reserve(Dirs.Num());
+		for (int32 DirIdx = 0; DirIdx < Dirs.Num(); ++DirIdx)
+		{
+			FColorizedFoldersCachedDir& CachedDir = Dirs[DirIdx];
+			CachedDir.Children.Reset();
+			PathToDir.Add(CachedDir.Path, DirIdx);
+
+			if (!CachedDir.bIsRoot)
+			{
+				const FStringView ParentPath = FPathViews::GetPath(CachedDir.Path);
+				if (const int32* ParentIdx = PathToDir.FindByHash(GetTypeHash(ParentPath), ParentPath))
+				{
+					Dirs[*ParentIdx].Children.Add(DirIdx);
+				}
+			}
+		}
+	}
+}
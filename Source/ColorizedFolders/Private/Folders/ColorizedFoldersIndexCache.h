@@ -0,0 +1,118 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UE::ColorizedFolders
+{
+	class FColorizedFoldersAppliedColors;
+	struct FColorizedFoldersScanResult;
+
+	/** A single folder stored in the index cache. */
+	struct FColorizedFoldersCachedDir
+	{
+		/** Package path of the folder, e.g. "/Game/Characters". */
+		FString Path;
+
+		/** Modification time of the directory on disk when it was listed, FDateTime::MinValue() if unknown. */
+		FDateTime Timestamp = FDateTime::MinValue();
+
+		/** The color we applied to the folder. */
+		TOptional<FLinearColor> Color;
+
+		/** Scheme the folder matched itself when the cache was built, or INDEX_NONE. */
+		int32 SchemeIndex = INDEX_NONE;
+
+		/** Indices of the direct child folders in the cache. */
+		TArray<int32> Children;
+
+		/** True for the package roots of mount points, which are never colored themselves. */
+		bool bIsRoot = false;
+	};
+
+	/**
+	 * Folder index of the last full update, persisted under Saved/ColorizedFolders between editor sessions.
+	 * On startup the cached folders and their colors are used right away, and the scan only lists the directories
+	 * whose modification time has changed since. Unchanged directories reuse their cached children instead.
+	 * The ColorizedFolders commandlet writes the same format, see GetPrecomputedFilename().
+	 */
+	class FColorizedFoldersIndexCache
+	{
+	public:
+		/** Returns the file the cache of the current project is stored in. */
+		static FString GetDefaultFilename();
+
+		/** Returns the default file the ColorizedFolders commandlet writes its precomputed folder index to. */
+		static FString GetPrecomputedFilename();
+
+		/** Rebuilds the cache from a full scan and the colors we applied afterwards. */
+		void Build(const FColorizedFoldersScanResult& InScanResult, const FColorizedFoldersAppliedColors& InAppliedColors);
+
+		/** Remembers the theme and the hash of the schemes the cached folders have been matched against. */
+		void SetSchemes(const FGuid& InThemeId, uint32 InSchemesHash)
+		{
+			ThemeId = InThemeId;
+			SchemesHash = InSchemesHash;
+		}
+
+		/** Returns true if the cached scheme indices and colors have been resolved with the given schemes. */
+		bool HasSchemes(const FGuid& InThemeId, uint32 InSchemesHash) const
+		{
+			return ThemeId.IsValid() && ThemeId == InThemeId && SchemesHash == InSchemesHash;
+		}
+
+		/** Remembers the modification time of the precomputed folder index this cache has been built on top of. */
+		void SetPrecomputedTimestamp(const FDateTime& InTimestamp)
+		{
+			PrecomputedTimestamp = InTimestamp;
+		}
+
+		/** Returns the modification time of the precomputed folder index this cache has been built on top of, FDateTime::MinValue() if none. */
+		const FDateTime& GetPrecomputedTimestamp() const
+		{
+			return PrecomputedTimestamp;
+		}
+
+		/** Updates the cached colors to the ones we currently applied. */
+		void UpdateColors(const FColorizedFoldersAppliedColors& InAppliedColors);
+
+		/** Loads the cache from disk. Returns false if it doesn't exist or was written by an incompatible version. */
+		bool Load(const FString& InFilename);
+
+		/** Writes the cache to disk. */
+		bool Save(const FString& InFilename) const;
+
+		/** Returns all cached folders, parents are always stored before their children. */
+		TConstArrayView<FColorizedFoldersCachedDir> GetDirs() const
+		{
+			return Dirs;
+		}
+
+		/** Returns the cached folder with the given package path, or nullptr. */
+		const FColorizedFoldersCachedDir* FindDir(FStringView InPath) const
+		{
+			const int32* DirIndex = PathToDir.FindByHash(GetTypeHash(InPath), InPath);
+			return DirIndex ? &Dirs[*DirIndex] : nullptr;
+		}
+
+		/** Returns true if nothing is cached. */
+		bool IsEmpty() const
+		{
+			return Dirs.IsEmpty();
+		}
+
+	private:
+		/** Sorts parents before their children and links them up. */
+		void BuildLookups();
+
+		TArray<FColorizedFoldersCachedDir> Dirs;
+
+		FGuid ThemeId;
+		uint32 SchemesHash = 0;
+		FDateTime PrecomputedTimestamp = FDateTime::MinValue();
+
+		/** Lookup of the index into Dirs. FString keys are hashed and compared case-insensitively. */
+		TMap<FString, int32> PathToDir;
+	};
+}
@@ -0,0 +1,154 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "ColorizedFoldersMountTable.h"
+
+#include "ColorizedFoldersUtils.h"
+#include "Interfaces/IPluginManager.h"
+
+namespace UE::ColorizedFolders
+{
+	void FColorizedFoldersMountTable::Build()
+	{
+		Reset();
+
+		AddMountPoint(TEXT("Game"), FPaths::ProjectContentDir(), TEXT("/Game"));
+
+		for (const TSharedRef<IPlugin>& Plugin : IPluginManager::Get().GetDiscoveredPlugins())
+		{
+			if (ShouldIterateThroughPlugin(Plugin))
+			{
+				AddMountPoint(Plugin->GetName(), Plugin->GetContentDir(), MakePluginVirtualRoot(Plugin->GetName(), Plugin->GetDescriptor().EditorCustomVirtualPath));
+			}
+		}
+	}
+
+	void FColorizedFoldersMountTable::Reset()
+	{
+		MountPoints.Reset();
+		ContentDirToMount.Reset();
+		NameToMount.Reset();
+		VirtualRootToMount.Reset();
+	}
+
+	void FColorizedFoldersMountTable::AddMountPoint(const FString& InName, const FString& InContentDir, const FString& InVirtualRoot)
+	{
+		FColorizedFoldersMountPoint MountPoint;
+		MountPoint.Name = InName;
+		MountPoint.ContentDir = FPaths::ConvertRelativePathToFull(InContentDir);
+		FPaths::NormalizeDirectoryName(MountPoint.ContentDir);
+		MountPoint.PackageRoot = TEXT("/") + InName;
+		MountPoint.VirtualRoot = InVirtualRoot;
+
+		const int32 MountIndex = MountPoints.Num();
+		ContentDirToMount.Add(MountPoint.ContentDir, MountIndex);
+		NameToMount.Add(MountPoint.Name, MountIndex);
+		VirtualRootToMount.Add(MountPoint.VirtualRoot, MountIndex);
+		MountPoints.Add(MoveTemp(MountPoint));
+	}
+
+	FString FColorizedFoldersMountTable::MakePluginVirtualRoot(const FString& InPluginName, const FString& InCustomVirtualPath)
+	{
+		FStringView CustomVirtualPath = InCustomVirtualPath;
+		while (CustomVirtualPath.StartsWith(TEXT('/')))
+		{
+			CustomVirtualPath.RightChopInline(1);
+		}
+		while (CustomVirtualPath.EndsWith(TEXT('/')))
+		{
+			CustomVirtualPath.LeftChopInline(1);
+		}
+
+		// The Content Browser nests custom virtual paths below "/Plugins" as well, e.g. "/Plugins/Custom/MyPlugin"
+		TStringBuilder<256> VirtualRoot;
+		VirtualRoot << TEXT("/Plugins");
+		if (!CustomVirtualPath.IsEmpty())
+		{
+			VirtualRoot << TEXT('/') << CustomVirtualPath;
+		}
+		VirtualRoot << TEXT('/') << InPluginName;
+		return FString(VirtualRoot);
+	}
+
+	const FColorizedFoldersMountPoint* FColorizedFoldersMountTable::FindByPhysicalPath(FStringView InPhysicalPath) const
+	{
+		// Every content dir ends in "/Content", so only those prefixes have to be looked up.
+		// Keep the last hit, so content dirs nested inside other content dirs resolve to the innermost one.
+		static constexpr FStringView ContentSegment = TEXTVIEW("/Content");
+
+		const FColorizedFoldersMountPoint* Result = nullptr;
+		for (int32 Idx = InPhysicalPath.Find(ContentSegment, 0, ESearchCase::IgnoreCase); Idx != INDEX_NONE;
+			Idx = InPhysicalPath.Find(ContentSegment, Idx + 1, ESearchCase::IgnoreCase))
+		{
+			const int32 PrefixLen = Idx + ContentSegment.Len();
+			if (PrefixLen < InPhysicalPath.Len() && InPhysicalPath[PrefixLen] != TEXT('/'))
+			{
+				continue;
+			}
+
+			const FStringView Prefix = InPhysicalPath.Left(PrefixLen);
+			if (const int32* MountIndex = ContentDirToMount.FindByHash(GetTypeHash(Prefix), Prefix))
+			{
+				Result = &MountPoints[*MountIndex];
+			}
+		}
+
+		return Result;
+	}
+
+	const FColorizedFoldersMountPoint* FColorizedFoldersMountTable::FindByPackagePath(FStringView InPackagePath) const
+	{
+		FStringView RootName = InPackagePath.RightChop(1);
+		int32 SlashIdx = INDEX_NONE;
+		if (RootName.FindChar(TEXT('/'), SlashIdx))
+		{
+			RootName.LeftInline(SlashIdx);
+		}
+
+		const int32* MountIndex = NameToMount.FindByHash(GetTypeHash(RootName), RootName);
+		return MountIndex ? &MountPoints[*MountIndex] : nullptr;
+	}
+
+	bool FColorizedFoldersMountTable::TryConvertPhysicalToPackagePath(FStringView InPhysicalPath, FStringBuilderBase& OutPackagePath) const
+	{
+		if (const FColorizedFoldersMountPoint* MountPoint = FindByPhysicalPath(InPhysicalPath))
+		{
+			AppendPackagePath(*MountPoint, InPhysicalPath, OutPackagePath);
+			return true;
+		}
+
+		return false;
+	}
+
+	bool FColorizedFoldersMountTable::TryConvertPackageToVirtualPath(FStringView InPackagePath, FStringBuilderBase& OutVirtualPath) const
+	{
+		if (const FColorizedFoldersMountPoint* MountPoint = FindByPackagePath(InPackagePath))
+		{
+			OutVirtualPath << MountPoint->VirtualRoot << InPackagePath.RightChop(MountPoint->PackageRoot.Len());
+			return true;
+		}
+
+		return false;
+	}
+
+	bool FColorizedFoldersMountTable::TryConvertVirtualToPackagePath(FStringView InVirtualPath, FStringBuilderBase& OutPackagePath) const
+	{
+		// Virtual roots can span multiple segments, so probe every segment boundary
+		for (int32 Idx = 1; Idx <= InVirtualPath.Len(); ++Idx)
+		{
+			if (Idx < InVirtualPath.Len() && InVirtualPath[Idx] != TEXT('/'))
+			{
+				continue;
+			}
+
+			const FStringView Prefix = InVirtualPath.Left(Idx);
+			if (const int32* MountIndex = VirtualRootToMount.FindByHash(GetTypeHash(Prefix), Prefix))
+			{
+				OutPackagePath << MountPoints[*MountIndex].PackageRoot << InVirtualPath.RightChop(Idx);
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
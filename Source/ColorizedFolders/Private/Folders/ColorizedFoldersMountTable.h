@@ -0,0 +1,88 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UE::ColorizedFolders
+{
+	/** A content root that is mounted in the Content Browser, e.g. the project or a plugin's content dir. */
+	struct FColorizedFoldersMountPoint
+	{
+		/** Name of the mount point, "Game" for the project or the plugin name. */
+		FString Name;
+
+		/** Absolute physical content dir, using forward slashes and without trailing slash. */
+		FString ContentDir;
+
+		/** Package path of the content dir, e.g. "/Game" or "/MyPlugin". */
+		FString PackageRoot;
+
+		/** Path of the content dir as shown in the Content Browser, e.g. "/Game" or "/Plugins/MyPlugin". */
+		FString VirtualRoot;
+	};
+
+	/**
+	 * Table of all mounted content roots, built once per full update.
+	 * Converts between physical dirs, package paths and Content Browser virtual paths with a single hash lookup
+	 * on string views, writing the result into a caller provided string builder.
+	 */
+	class FColorizedFoldersMountTable
+	{
+	public:
+		/** Rebuilds the table from the project content dir and all plugins that can contain project content. */
+		void Build();
+
+		/** Removes all mount points. */
+		void Reset();
+
+		/**
+		 * Adds a content root to the table.
+		 * @param InName			Name of the mount point, which is also its package root.
+		 * @param InContentDir		Physical content dir, may be relative.
+		 * @param InVirtualRoot		Path of the content dir in the Content Browser.
+		 */
+		void AddMountPoint(const FString& InName, const FString& InContentDir, const FString& InVirtualRoot);
+
+		/**
+		 * Returns the Content Browser path of a plugin's content, honoring FPluginDescriptor::EditorCustomVirtualPath
+		 * the same way the Content Browser does, e.g. "/Plugins/MyPlugin" or "/Plugins/Custom/MyPlugin".
+		 */
+		static FString MakePluginVirtualRoot(const FString& InPluginName, const FString& InCustomVirtualPath);
+
+		/** Returns all mount points. */
+		TConstArrayView<FColorizedFoldersMountPoint> GetMountPoints() const
+		{
+			return MountPoints;
+		}
+
+		/** Returns the mount point that contains the physical path, or nullptr. */
+		const FColorizedFoldersMountPoint* FindByPhysicalPath(FStringView InPhysicalPath) const;
+
+		/** Returns the mount point of the package path, or nullptr. */
+		const FColorizedFoldersMountPoint* FindByPackagePath(FStringView InPackagePath) const;
+
+		/** Converts an absolute physical dir to its package path, e.g. "D:/Project/Content/Maps" to "/Game/Maps". */
+		bool TryConvertPhysicalToPackagePath(FStringView InPhysicalPath, FStringBuilderBase& OutPackagePath) const;
+
+		/** Converts a package path to the path shown in the Content Browser, e.g. "/MyPlugin/Maps" to "/Plugins/MyPlugin/Maps". */
+		bool TryConvertPackageToVirtualPath(FStringView InPackagePath, FStringBuilderBase& OutVirtualPath) const;
+
+		/** Converts a Content Browser path back to its package path, e.g. "/Plugins/MyPlugin/Maps" to "/MyPlugin/Maps". */
+		bool TryConvertVirtualToPackagePath(FStringView InVirtualPath, FStringBuilderBase& OutPackagePath) const;
+
+		/** Appends the package path of a physical dir below the given mount point. */
+		static void AppendPackagePath(const FColorizedFoldersMountPoint& InMountPoint, FStringView InPhysicalPath, FStringBuilderBase& OutPackagePath)
+		{
+			OutPackagePath << InMountPoint.PackageRoot << InPhysicalPath.RightChop(InMountPoint.ContentDir.Len());
+		}
+
+	private:
+		TArray<FColorizedFoldersMountPoint> MountPoints;
+
+		/** Lookups of the mount point index. FString keys are hashed and compared case-insensitively. */
+		TMap<FString, int32> ContentDirToMount;
+		TMap<FString, int32> NameToMount;
+		TMap<FString, int32> VirtualRootToMount;
+	};
+}
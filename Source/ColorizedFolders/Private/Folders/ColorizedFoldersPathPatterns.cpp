@@ -0,0 +1,143 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "ColorizedFoldersPathPatterns.h"
+
+#include "ColorizedFoldersPathTrie.h"
+#include "Algo/BinarySearch.h"
+
+namespace UE::ColorizedFolders
+{
+	void FColorizedFoldersPathPatterns::Reset()
+	{
+		Nodes.Reset();
+		Nodes.AddDefaulted();
+	}
+
+	void FColorizedFoldersPathPatterns::AddPattern(FStringView InPattern, int32 InValue)
+	{
+		int32 NodeIndex = RootNode;
+		FColorizedFoldersPathTrie::ForEachSegment(InPattern, [this, &NodeIndex](FStringView Segment)
+		{
+			int32 ChildIndex = INDEX_NONE;
+			if (Segment == TEXTVIEW("**"))
+			{
+				ChildIndex = Nodes[NodeIndex].AnyDepthChild;
+				if (ChildIndex == INDEX_NONE)
+				{
+					ChildIndex = Nodes.AddDefaulted();
+					Nodes[ChildIndex].bAnyDepth = true;
+					Nodes[NodeIndex].AnyDepthChild = ChildIndex;
+				}
+			}
+			else if (FColorizedFoldersGlobAutomaton::IsPattern(Segment))
+			{
+				const FPatternChild* Existing = Nodes[NodeIndex].PatternChildren.FindByPredicate([Segment](const FPatternChild& PatternChild)
+				{
+					return PatternChild.Pattern.Equals(Segment, ESearchCase::IgnoreCase);
+				});
+
+				if (Existing)
+				{
+					ChildIndex = Existing->Node;
+				}
+				else
+				{
+					ChildIndex = Nodes.AddDefaulted();
+					FPatternChild& PatternChild = Nodes[NodeIndex].PatternChildren.AddDefaulted_GetRef();
+					PatternChild.Pattern = FString(Segment);
+					PatternChild.Automaton.AddPattern(Segment, 0);
+					PatternChild.Automaton.Compile();
+					PatternChild.Node = ChildIndex;
+				}
+			}
+			else if (const int32* LiteralChild = Nodes[NodeIndex].LiteralChildren.FindByHash(GetTypeHash(Segment), Segment))
+			{
+				ChildIndex = *LiteralChild;
+			}
+			else
+			{
+				ChildIndex = Nodes.AddDefaulted();
+				Nodes[NodeIndex].LiteralChildren.Add(FString(Segment), ChildIndex);
+			}
+
+			NodeIndex = ChildIndex;
+			return true;
+		});
+
+		// An empty pattern would match every mount root
+		if (NodeIndex != RootNode)
+		{
+			Nodes[NodeIndex].SchemeIndex = FMath::Max(Nodes[NodeIndex].SchemeIndex, InValue);
+		}
+	}
+
+	void FColorizedFoldersPathPatterns::GetRootState(FColorizedFoldersPathState& OutState) const
+	{
+		OutState.Reset();
+		AddNode(RootNode, OutState);
+	}
+
+	void FColorizedFoldersPathPatterns::Advance(const FColorizedFoldersPathState& InState, FStringView InSegment, FColorizedFoldersPathState& OutState) const
+	{
+		OutState.Reset();
+		for (const int32 NodeIndex : InState)
+		{
+			const FNode& Node = Nodes[NodeIndex];
+			if (Node.bAnyDepth)
+			{
+				AddNode(NodeIndex, OutState);
+			}
+
+			if (const int32* LiteralChild = Node.LiteralChildren.FindByHash(GetTypeHash(InSegment), InSegment))
+			{
+				AddNode(*LiteralChild, OutState);
+			}
+
+			for (const FPatternChild& PatternChild : Node.PatternChildren)
+			{
+				if (PatternChild.Automaton.Match(InSegment) != INDEX_NONE)
+				{
+					AddNode(PatternChild.Node, OutState);
+				}
+			}
+		}
+	}
+
+	void FColorizedFoldersPathPatterns::Walk(FStringView InPath, FColorizedFoldersPathState& OutState) const
+	{
+		GetRootState(OutState);
+
+		FColorizedFoldersPathState NextState;
+		FColorizedFoldersPathTrie::ForEachSegment(InPath, [this, &OutState, &NextState](FStringView Segment)
+		{
+			Advance(OutState, Segment, NextState);
+			Swap(OutState, NextState);
+			return !OutState.IsEmpty();
+		});
+	}
+
+	int32 FColorizedFoldersPathPatterns::GetMatch(const FColorizedFoldersPathState& InState) const
+	{
+		int32 SchemeIndex = INDEX_NONE;
+		for (const int32 NodeIndex : InState)
+		{
+			SchemeIndex = FMath::Max(SchemeIndex, Nodes[NodeIndex].SchemeIndex);
+		}
+		return SchemeIndex;
+	}
+
+	void FColorizedFoldersPathPatterns::AddNode(int32 InNode, FColorizedFoldersPathState& OutState) const
+	{
+		// "**" may also match no segment at all, so it's active as soon as its parent is
+		for (int32 NodeIndex = InNode; NodeIndex != INDEX_NONE; NodeIndex = Nodes[NodeIndex].AnyDepthChild)
+		{
+			const int32 InsertIdx = Algo::LowerBound(OutState, NodeIndex);
+			if (OutState.IsValidIndex(InsertIdx) && OutState[InsertIdx] == NodeIndex)
+			{
+				return;
+			}
+			OutState.Insert(NodeIndex, InsertIdx);
+		}
+	}
+}
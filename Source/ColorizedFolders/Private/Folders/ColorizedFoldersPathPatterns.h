@@ -0,0 +1,86 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ColorizedFoldersGlobAutomaton.h"
+
+namespace UE::ColorizedFolders
+{
+	/** Nodes of the path pattern trie a folder has reached, sorted. */
+	using FColorizedFoldersPathState = TArray<int32, TInlineAllocator<4>>;
+
+	/**
+	 * Multi-segment path patterns, stored in a trie of path segments. A segment is either a literal name, a glob pattern
+	 * matching a single folder like "*" or "Char*" (see FColorizedFoldersGlobAutomaton), or "**", which matches any
+	 * number of folders including none. Segments are compared case-insensitively.
+	 *
+	 * The state of a folder is derived from the state of its parent by consuming a single segment, so a folder walk
+	 * evaluates every folder in O(1) instead of matching its full path against every pattern.
+	 */
+	class FColorizedFoldersPathPatterns
+	{
+	public:
+		static constexpr int32 RootNode = 0;
+
+		FColorizedFoldersPathPatterns()
+		{
+			Reset();
+		}
+
+		/** Removes all patterns. */
+		void Reset();
+
+		/** Adds a pattern. If several patterns match the same folder, the highest value wins. */
+		void AddPattern(FStringView InPattern, int32 InValue);
+
+		/** Returns the state before any segment has been consumed. */
+		void GetRootState(FColorizedFoldersPathState& OutState) const;
+
+		/** Consumes a single segment. */
+		void Advance(const FColorizedFoldersPathState& InState, FStringView InSegment, FColorizedFoldersPathState& OutState) const;
+
+		/** Consumes all segments of a path, starting from the root. */
+		void Walk(FStringView InPath, FColorizedFoldersPathState& OutState) const;
+
+		/** Returns the highest value of all patterns that end in the state, or INDEX_NONE. */
+		int32 GetMatch(const FColorizedFoldersPathState& InState) const;
+
+		/** Returns true if no patterns have been added. */
+		bool IsEmpty() const
+		{
+			return Nodes.Num() == 1;
+		}
+
+	private:
+		/** A child matched by a glob pattern. */
+		struct FPatternChild
+		{
+			FString Pattern;
+			FColorizedFoldersGlobAutomaton Automaton;
+			int32 Node = INDEX_NONE;
+		};
+
+		struct FNode
+		{
+			/** Children by literal segment. FString keys are hashed and compared case-insensitively. */
+			TMap<FString, int32> LiteralChildren;
+
+			TArray<FPatternChild> PatternChildren;
+
+			/** Child for "**", which is active together with this node. */
+			int32 AnyDepthChild = INDEX_NONE;
+
+			/** True for "**" nodes, which stay active for any segment. */
+			bool bAnyDepth = false;
+
+			/** Highest value of the patterns ending at this node, or INDEX_NONE. */
+			int32 SchemeIndex = INDEX_NONE;
+		};
+
+		/** Adds a node to the state along with every "**" node that is active together with it. */
+		void AddNode(int32 InNode, FColorizedFoldersPathState& OutState) const;
+
+		TArray<FNode> Nodes;
+	};
+}
@@ -0,0 +1,116 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UE::ColorizedFolders
+{
+	/**
+	 * Trie of path segments, e.g. "/Game/Foo/Bar" is stored as Game -> Foo -> Bar.
+	 * Used to check whether a path is equal to or below any of the stored paths in O(depth),
+	 * independent of how many paths have been stored. Segments are compared case-insensitively.
+	 */
+	class FColorizedFoldersPathTrie
+	{
+	public:
+		static constexpr int32 RootNode = 0;
+
+		FColorizedFoldersPathTrie()
+		{
+			Reset();
+		}
+
+		/** Removes all paths from the trie. */
+		void Reset()
+		{
+			Nodes.Reset();
+			Nodes.AddDefaulted();
+		}
+
+		/** Adds a path to the trie. */
+		void Insert(FStringView InPath)
+		{
+			int32 NodeIndex = RootNode;
+			ForEachSegment(InPath, [this, &NodeIndex](FStringView Segment)
+			{
+				if (const int32* ChildIndex = Nodes[NodeIndex].Children.FindByHash(GetTypeHash(Segment), Segment))
+				{
+					NodeIndex = *ChildIndex;
+				}
+				else
+				{
+					const int32 NewIndex = Nodes.AddDefaulted();
+					Nodes[NodeIndex].Children.Add(FString(Segment), NewIndex);
+					NodeIndex = NewIndex;
+				}
+				return true;
+			});
+
+			Nodes[NodeIndex].bTerminal = true;
+		}
+
+		/** Returns the child of a node for the given segment, or INDEX_NONE. */
+		int32 FindChild(int32 InNodeIndex, FStringView InSegment) const
+		{
+			const int32* ChildIndex = Nodes[InNodeIndex].Children.FindByHash(GetTypeHash(InSegment), InSegment);
+			return ChildIndex ? *ChildIndex : INDEX_NONE;
+		}
+
+		/** Returns true if a stored path ends at this node. */
+		bool IsTerminal(int32 InNodeIndex) const
+		{
+			return Nodes[InNodeIndex].bTerminal;
+		}
+
+		/** Returns true if no paths have been stored. */
+		bool IsEmpty() const
+		{
+			return Nodes[RootNode].Children.IsEmpty();
+		}
+
+		/** Returns true if the path, or any of its parents, has been stored. */
+		bool ContainsPathOrParent(FStringView InPath) const
+		{
+			bool bFound = false;
+			int32 NodeIndex = RootNode;
+			ForEachSegment(InPath, [this, &NodeIndex, &bFound](FStringView Segment)
+			{
+				NodeIndex = FindChild(NodeIndex, Segment);
+				bFound = NodeIndex != INDEX_NONE && IsTerminal(NodeIndex);
+				return NodeIndex != INDEX_NONE && !bFound;
+			});
+
+			return bFound;
+		}
+
+		/** Calls the visitor for every non-empty segment of the path until it returns false. */
+		template <typename VisitorType>
+		static void ForEachSegment(FStringView InPath, VisitorType&& Visitor)
+		{
+			int32 SegmentStart = 0;
+			for (int32 Idx = 0; Idx <= InPath.Len(); ++Idx)
+			{
+				if (Idx == InPath.Len() || InPath[Idx] == TEXT('/') || InPath[Idx] == TEXT('\\'))
+				{
+					if (Idx > SegmentStart && !Visitor(InPath.Mid(SegmentStart, Idx - SegmentStart)))
+					{
+						return;
+					}
+					SegmentStart = Idx + 1;
+				}
+			}
+		}
+
+	private:
+		struct FNode
+		{
+			/** Child nodes by segment name. FString keys are hashed and compared case-insensitively. */
+			TMap<FString, int32> Children;
+
+			bool bTerminal = false;
+		};
+
+		TArray<FNode> Nodes;
+	};
+}
@@ -0,0 +1,317 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "ColorizedFoldersScanner.h"
+
+#include "ColorizedFoldersSettings.h"
+#include "ColorizedFoldersStats.h"
+#include "ColorizedFoldersTrace.h"
+#include "Algo/Count.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/PathViews.h"
+#include "Tasks/Task.h"
+
+namespace UE::ColorizedFolders::Private
+{
+	/** State shared by all tasks of a parallel scan. Lives on the stack of FColorizedFoldersDirScanner::Scan, which waits for all of them. */
+	struct FParallelScan
+	{
+		FParallelScan(const FColorizedFoldersPathTrie& InBlacklist, const FColorizedFoldersIndexCache* InCache,
+			TFunctionRef<int32(const FString&, const FColorizedFoldersPathState*, FColorizedFoldersPathState&)> InMatchFolder, TFunctionRef<bool()> InIsCancelled, FColorizedFoldersScanResult& OutResult)
+			: Blacklist(InBlacklist)
+			, Cache(InCache)
+			, MatchFolder(InMatchFolder)
+			, IsCancelled(InIsCancelled)
+			, Result(OutResult)
+		{
+		}
+
+		/** A directory that still has to be listed. */
+		struct FPendingDir
+		{
+			/** Absolute physical path. */
+			FString Dir;
+
+			FString PackagePath;
+
+			/** Position of this folder in the blacklist trie, INDEX_NONE once no blacklisted path can be below it. */
+			int32 BlacklistNode = INDEX_NONE;
+
+			/** True for the content dir of a mount point. */
+			bool bIsRoot = false;
+
+			/** Path pattern state of the parent folder, unused for roots. */
+			FColorizedFoldersPathState ParentPathState;
+		};
+
+		/** Lists a directory and spreads its subdirectories across new tasks. TraceName names the timing events of the mount point. */
+		void ScanDir(const FColorizedFoldersMountPoint& MountPoint, const FString& TraceName, FPendingDir Current)
+		{
+			SCOPE_CYCLE_COUNTER(STAT_ColorizedFolders_Scan);
+			COLORIZEDFOLDERS_TRACE_SCOPE_TEXT(*TraceName);
+
+			IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+			TArray<FPendingDir> ChildDirs;
+			FColorizedFoldersScanResult LocalResult;
+
+			// Keep descending into one of the subdirectories on this task, so leaf folders don't cost a task each
+			for (;;)
+			{
+				if (bCancelled.load(std::memory_order_relaxed) || IsCancelled())
+				{
+					bCancelled = true;
+					return;
+				}
+
+				// The directory may have been deleted since it was cached
+				const FDateTime Timestamp = PlatformFile.GetTimeStamp(*Current.Dir);
+				if (Timestamp == FDateTime::MinValue())
+				{
+					break;
+				}
+
+				FColorizedFoldersPathState PathState;
+				if (Current.bIsRoot)
+				{
+					LocalResult.Roots.Add(Current.PackagePath);
+					LocalResult.RootTimestamps.Add(Timestamp);
+
+					// Roots aren't colored by the scan, but their children continue from their path state
+					MatchFolder(Current.PackagePath, nullptr, PathState);
+				}
+				else
+				{
+					LocalResult.SchemeIndices.Add(MatchFolder(Current.PackagePath, &Current.ParentPathState, PathState));
+					LocalResult.Dirs.Add(Current.PackagePath);
+					LocalResult.Timestamps.Add(Timestamp);
+				}
+
+				auto AddChildDir = [&](FStringView ChildDir)
+				{
+					// No need to check auto-generated folders for wp, nor anything below them
+					const FStringView DirName = FPathViews::GetCleanFilename(ChildDir);
+					if (FColorizedFoldersDirScanner::IsExcludedDirName(DirName))
+					{
+						++LocalResult.NumPruned;
+						return;
+					}
+
+					// Check if the directory is blacklisted, which also skips its whole subtree
+					const int32 ChildBlacklistNode = Current.BlacklistNode != INDEX_NONE ? Blacklist.FindChild(Current.BlacklistNode, DirName) : INDEX_NONE;
+					if (ChildBlacklistNode != INDEX_NONE && Blacklist.IsTerminal(ChildBlacklistNode))
+					{
+						++LocalResult.NumPruned;
+						return;
+					}
+
+					TStringBuilder<512> PackagePath;
+					FColorizedFoldersMountTable::AppendPackagePath(MountPoint, ChildDir, PackagePath);
+					ChildDirs.Add({ FString(ChildDir), FString(PackagePath.ToView()), ChildBlacklistNode, false, PathState });
+				};
+
+				// Adding or removing a subdirectory updates the modification time, so unchanged directories still have the cached children
+				ChildDirs.Reset();
+				const FColorizedFoldersCachedDir* CachedDir = Cache ? Cache->FindDir(Current.PackagePath) : nullptr;
+				if (CachedDir && CachedDir->Timestamp == Timestamp)
+				{
+					TStringBuilder<512> ChildDir;
+					for (const int32 ChildIdx : CachedDir->Children)
+					{
+						ChildDir.Reset();
+						ChildDir << Current.Dir << TEXT('/') << FPathViews::GetCleanFilename(Cache->GetDirs()[ChildIdx].Path);
+						AddChildDir(ChildDir.ToView());
+					}
+				}
+				else
+				{
+					PlatformFile.IterateDirectory(*Current.Dir, [&AddChildDir](const TCHAR* FilenameOrDirectory, bool bIsDirectory)
+					{
+						if (bIsDirectory)
+						{
+							AddChildDir(FilenameOrDirectory);
+						}
+						return true;
+					});
+				}
+
+				if (ChildDirs.IsEmpty())
+				{
+					break;
+				}
+
+				// Idle workers steal these from our queue
+				for (int32 ChildIdx = 0; ChildIdx < ChildDirs.Num() - 1; ++ChildIdx)
+				{
+					UE::Tasks::AddNested(UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, &MountPoint, &TraceName, ChildDir = MoveTemp(ChildDirs[ChildIdx])]() mutable
+					{
+						ScanDir(MountPoint, TraceName, MoveTemp(ChildDir));
+					},
+					UE::Tasks::ETaskPriority::BackgroundNormal));
+				}
+
+				Current = MoveTemp(ChildDirs.Last());
+			}
+
+			INC_DWORD_STAT_BY(STAT_ColorizedFolders_FoldersVisited, LocalResult.Dirs.Num() + LocalResult.Roots.Num());
+			INC_DWORD_STAT_BY(STAT_ColorizedFolders_FoldersPruned, LocalResult.NumPruned);
+			INC_DWORD_STAT_BY(STAT_ColorizedFolders_FoldersMatched, Algo::CountIf(LocalResult.SchemeIndices, [](int32 SchemeIndex) { return SchemeIndex != INDEX_NONE; }));
+
+			FScopeLock Lock(&ResultLock);
+			Result.NumPruned += LocalResult.NumPruned;
+			Result.Dirs.Append(MoveTemp(LocalResult.Dirs));
+			Result.SchemeIndices.Append(MoveTemp(LocalResult.SchemeIndices));
+			Result.Timestamps.Append(MoveTemp(LocalResult.Timestamps));
+			Result.Roots.Append(MoveTemp(LocalResult.Roots));
+			Result.RootTimestamps.Append(MoveTemp(LocalResult.RootTimestamps));
+		}
+
+		const FColorizedFoldersPathTrie& Blacklist;
+		const FColorizedFoldersIndexCache* Cache;
+		TFunctionRef<int32(const FString&, const FColorizedFoldersPathState*, FColorizedFoldersPathState&)> MatchFolder;
+		TFunctionRef<bool()> IsCancelled;
+
+		FCriticalSection ResultLock;
+		FColorizedFoldersScanResult& Result;
+
+		std::atomic<bool> bCancelled = false;
+	};
+}
+
+namespace UE::ColorizedFolders
+{
+	void FColorizedFoldersDirScanner::SetBlacklist(TConstArrayView<FDirectoryPath> InBlacklist)
+	{
+		Blacklist.Reset();
+		for (const FDirectoryPath& BlacklistedDir : InBlacklist)
+		{
+			if (!BlacklistedDir.Path.IsEmpty())
+			{
+				Blacklist.Insert(BlacklistedDir.Path);
+			}
+		}
+	}
+
+	bool FColorizedFoldersDirScanner::Scan(TConstArrayView<FColorizedFoldersMountPoint> InMountPoints, const FColorizedFoldersIndexCache* InCache,
+		TFunctionRef<int32(const FString&, const FColorizedFoldersPathState*, FColorizedFoldersPathState&)> MatchFolder, TFunctionRef<bool()> IsCancelled, FColorizedFoldersScanResult& OutResult) const
+	{
+		Private::FParallelScan ParallelScan(Blacklist, InCache, MatchFolder, IsCancelled, OutResult);
+
+		// Every task of a mount point reports under the same name, so the trace shows which content tree the time goes to
+		TArray<FString> TraceNames;
+		TraceNames.Reserve(InMountPoints.Num());
+
+		TArray<UE::Tasks::FTask> RootTasks;
+		for (const FColorizedFoldersMountPoint& MountPoint : InMountPoints)
+		{
+			const FString& TraceName = TraceNames.Add_GetRef(TEXT("ColorizedFolders::ScanMount ") + MountPoint.Name);
+
+			Private::FParallelScan::FPendingDir RootDir;
+			RootDir.Dir = MountPoint.ContentDir;
+			RootDir.PackagePath = MountPoint.PackageRoot;
+			RootDir.BlacklistNode = Blacklist.FindChild(FColorizedFoldersPathTrie::RootNode, MountPoint.Name);
+			RootDir.bIsRoot = true;
+
+			RootTasks.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [&ParallelScan, &MountPoint, &TraceName, RootDir = MoveTemp(RootDir)]() mutable
+			{
+				ParallelScan.ScanDir(MountPoint, TraceName, MoveTemp(RootDir));
+			},
+			UE::Tasks::ETaskPriority::BackgroundNormal));
+		}
+
+		// Nested tasks keep their root task from completing, so this waits for the whole tree
+		UE::Tasks::Wait(RootTasks);
+
+		return !ParallelScan.bCancelled;
+	}
+
+	bool FColorizedFoldersDirScanner::Scan(const IAssetRegistry& InAssetRegistry, TConstArrayView<FColorizedFoldersMountPoint> InMountPoints,
+		TFunctionRef<int32(const FString&, const FColorizedFoldersPathState*, FColorizedFoldersPathState&)> MatchFolder, TFunctionRef<bool()> IsCancelled, FColorizedFoldersScanResult& OutResult) const
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ColorizedFolders_Scan);
+
+		struct FPendingPath
+		{
+			FString Path;
+
+			/** Position of this folder in the blacklist trie, INDEX_NONE once no blacklisted path can be below it. */
+			int32 BlacklistNode;
+
+			FColorizedFoldersPathState PathState;
+		};
+
+		// Walk one mount point after the other, so the trace shows which content tree the time goes to
+		TArray<FPendingPath> PendingPaths;
+		for (const FColorizedFoldersMountPoint& MountPoint : InMountPoints)
+		{
+			COLORIZEDFOLDERS_TRACE_SCOPE_TEXT(*(TEXT("ColorizedFolders::ScanMount ") + MountPoint.Name));
+
+			FPendingPath& RootPath = PendingPaths.Add_GetRef({ MountPoint.PackageRoot, Blacklist.FindChild(FColorizedFoldersPathTrie::RootNode, MountPoint.Name) });
+			MatchFolder(RootPath.Path, nullptr, RootPath.PathState);
+			OutResult.Roots.Add(MountPoint.PackageRoot);
+			OutResult.RootTimestamps.Add(FDateTime::MinValue());
+
+			// Walk the cached path tree level by level instead of recursing, so excluded subtrees can be pruned
+			while (!PendingPaths.IsEmpty())
+			{
+				if (IsCancelled())
+				{
+					return false;
+				}
+
+				const FPendingPath Current = PendingPaths.Pop(EAllowShrinking::No);
+				InAssetRegistry.EnumerateSubPaths(Current.Path, [&](FString SubPath)
+				{
+					const FStringView DirName = FPathViews::GetCleanFilename(SubPath);
+					if (IsExcludedDirName(DirName))
+					{
+						++OutResult.NumPruned;
+						return true;
+					}
+
+					const int32 ChildBlacklistNode = Current.BlacklistNode != INDEX_NONE ? Blacklist.FindChild(Current.BlacklistNode, DirName) : INDEX_NONE;
+					if (ChildBlacklistNode != INDEX_NONE && Blacklist.IsTerminal(ChildBlacklistNode))
+					{
+						++OutResult.NumPruned;
+						return true;
+					}
+
+					FColorizedFoldersPathState PathState;
+					const int32 SchemeIndex = MatchFolder(SubPath, &Current.PathState, PathState);
+					INC_DWORD_STAT(STAT_ColorizedFolders_FoldersVisited);
+					if (SchemeIndex != INDEX_NONE)
+					{
+						INC_DWORD_STAT(STAT_ColorizedFolders_FoldersMatched);
+					}
+
+					OutResult.SchemeIndices.Add(SchemeIndex);
+					OutResult.Dirs.Add(SubPath);
+					OutResult.Timestamps.Add(FDateTime::MinValue());
+					PendingPaths.Add({ MoveTemp(SubPath), ChildBlacklistNode, MoveTemp(PathState) });
+					return true;
+				}, false);
+			}
+		}
+
+		return true;
+	}
+
+	bool FColorizedFoldersDirScanner::IsExcluded(FStringView InPackagePath) const
+	{
+		bool bExcluded = false;
+		FColorizedFoldersPathTrie::ForEachSegment(InPackagePath, [&bExcluded](FStringView Segment)
+		{
+			bExcluded = IsExcludedDirName(Segment);
+			return !bExcluded;
+		});
+
+		return bExcluded || Blacklist.ContainsPathOrParent(InPackagePath);
+	}
+
+	bool FColorizedFoldersDirScanner::IsExcludedDirName(FStringView InDirName)
+	{
+		return InDirName.Equals(TEXT("__ExternalActors__"), ESearchCase::IgnoreCase) ||
+			InDirName.Equals(TEXT("__ExternalObjects__"), ESearchCase::IgnoreCase);
+	}
+}
@@ -0,0 +1,78 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ColorizedFoldersPathTrie.h"
+#include "ColorizedFoldersMountTable.h"
+#include "ColorizedFoldersIndexCache.h"
+#include "ColorizedFoldersPathPatterns.h"
+
+class IAssetRegistry;
+struct FDirectoryPath;
+
+namespace UE::ColorizedFolders
+{
+	/** Folders collected by a full scan, along with the scheme they matched. */
+	struct FColorizedFoldersScanResult
+	{
+		/** Package paths of all folders. */
+		TArray<FString> Dirs;
+
+		/** Index of the winning scheme for each entry in Dirs, or INDEX_NONE. */
+		TArray<int32> SchemeIndices;
+
+		/** Modification time of each entry in Dirs, only filled by disk scans. */
+		TArray<FDateTime> Timestamps;
+
+		/** Package roots of the scanned mount points, along with the modification time of their content dir. */
+		TArray<FString> Roots;
+		TArray<FDateTime> RootTimestamps;
+
+		/** Number of excluded folders that have been skipped, each along with its whole subtree. */
+		int32 NumPruned = 0;
+	};
+
+	/**
+	 * Collects the package paths of all content folders, either from disk or from the Asset Registry.
+	 * Excluded folders (World Partition external actor/object folders and blacklisted folders) are pruned
+	 * together with their whole subtree, instead of being visited and ignored one by one.
+	 */
+	class FColorizedFoldersDirScanner
+	{
+	public:
+		/** Compiles the folders that should be skipped, including everything below them. */
+		void SetBlacklist(TConstArrayView<FDirectoryPath> InBlacklist);
+
+		/**
+		 * Collects all folders below the content dirs of the mount points as package paths, and resolves their scheme.
+		 * Every directory is listed by its own task, so large trees are spread across all worker threads, and the
+		 * task scheduler's work stealing keeps them busy. Blocks until the scan is done or has been cancelled.
+		 *
+		 * @param InCache		Folders of a previous scan. Directories whose modification time didn't change reuse their cached children.
+		 * @param MatchFolder	Returns the winning scheme of a folder given the path pattern state of its parent, and outputs the
+		 *						state of the folder for its children. Mount roots have no parent state. Called concurrently from worker threads.
+		 * @param IsCancelled	Returns true once the scan should stop. Called concurrently from worker threads.
+		 * @return False if the scan has been cancelled.
+		 */
+		bool Scan(TConstArrayView<FColorizedFoldersMountPoint> InMountPoints, const FColorizedFoldersIndexCache* InCache,
+			TFunctionRef<int32(const FString&, const FColorizedFoldersPathState*, FColorizedFoldersPathState&)> MatchFolder, TFunctionRef<bool()> IsCancelled, FColorizedFoldersScanResult& OutResult) const;
+
+		/**
+		 * Collects all folders below the package roots of the mount points from the paths cached by the Asset Registry,
+		 * and resolves their scheme the same way as the disk scan. Doesn't touch the disk and is safe to call from any thread.
+		 * @return False if the scan has been cancelled.
+		 */
+		bool Scan(const IAssetRegistry& InAssetRegistry, TConstArrayView<FColorizedFoldersMountPoint> InMountPoints,
+			TFunctionRef<int32(const FString&, const FColorizedFoldersPathState*, FColorizedFoldersPathState&)> MatchFolder, TFunctionRef<bool()> IsCancelled, FColorizedFoldersScanResult& OutResult) const;
+
+		/** Returns true if the folder, or any of its parents, should not be colorized. */
+		bool IsExcluded(FStringView InPackagePath) const;
+
+		/** Returns true for auto-generated folders whose subtree should never be visited. */
+		static bool IsExcludedDirName(FStringView InDirName);
+
+	private:
+		FColorizedFoldersPathTrie Blacklist;
+	};
+}
@@ -0,0 +1,46 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "ColorizedFoldersSchemeMatcher.h"
+
+#include "Themes/ColorizedFoldersTheme.h"
+
+namespace UE::ColorizedFolders
+{
+	void FColorizedFoldersSchemeMatcher::Compile(TConstArrayView<FColorizedFolderColorScheme> InSchemes)
+	{
+		Reset();
+
+		TArray<FString> Entries;
+		for (int32 SchemeIndex = 0; SchemeIndex < InSchemes.Num(); ++SchemeIndex)
+		{
+			const FColorizedFolderColorScheme& Scheme = InSchemes[SchemeIndex];
+
+			// Later schemes override earlier ones, same as when the schemes were applied one after another
+			Entries.Reset();
+			Scheme.FolderNames.ParseIntoArray(Entries, TEXT(","), true);
+			for (FString& FolderName : Entries)
+			{
+				FolderName.TrimStartAndEndInline();
+				if (!FolderName.IsEmpty())
+				{
+					AddFolderName(GetTypeHash(FStringView(FolderName)), FolderName, SchemeIndex);
+				}
+			}
+
+			Entries.Reset();
+			Scheme.ExplicitPaths.ParseIntoArray(Entries, TEXT(","), true);
+			for (FString& ExplicitPath : Entries)
+			{
+				ExplicitPath.TrimStartAndEndInline();
+				ExplicitPath.RemoveFromEnd(TEXT("/"));
+				if (!ExplicitPath.IsEmpty())
+				{
+					AddExplicitPath(GetTypeHash(FStringView(ExplicitPath)), ExplicitPath, SchemeIndex);
+				}
+			}
+		}
+
+		CompilePatterns();
+	}
+}
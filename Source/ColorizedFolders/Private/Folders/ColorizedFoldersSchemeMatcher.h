@@ -0,0 +1,181 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ColorizedFoldersGlobAutomaton.h"
+#include "ColorizedFoldersPathPatterns.h"
+#include "Algo/Unique.h"
+
+struct FColorizedFolderColorScheme;
+
+namespace UE::ColorizedFolders
+{
+	/**
+	 * Pre-compiled lookup of the folder names and explicit paths of all schemes in a theme.
+	 * Built once whenever a theme is applied, so matching a folder is a single hash lookup
+	 * regardless of how many schemes or folder names the theme contains.
+	 *
+	 * Priority, from highest to lowest:
+	 *  1. Explicit paths, compared against the full folder path.
+	 *  2. Explicit paths with wildcards, matched segment by segment (see FColorizedFoldersPathPatterns).
+	 *  3. Folder names, compared against the last segment of the folder path.
+	 *  4. Folder name patterns like "UI*" or "*_Data", matched by a single automaton (see FColorizedFoldersGlobAutomaton).
+	 * If several schemes match at the same priority, the scheme with the highest index wins.
+	 */
+	class FColorizedFoldersSchemeMatcher
+	{
+	public:
+		/** Compiles the folder names and explicit paths of the given schemes. */
+		void Compile(TConstArrayView<FColorizedFolderColorScheme> InSchemes);
+
+		/** Removes all folder names and explicit paths. */
+		void Reset()
+		{
+			FolderNameToScheme.Reset();
+			ExplicitPathToScheme.Reset();
+			FolderNamePatterns.Reset();
+			PathPatterns.Reset();
+		}
+
+		/**
+		 * Adds a folder name along with its precomputed case-insensitive hash, overriding earlier schemes.
+		 * Names using glob syntax are added as patterns, which only take effect once CompilePatterns() has been called.
+		 */
+		void AddFolderName(uint32 InHash, FStringView InFolderName, int32 InSchemeIndex)
+		{
+			if (FColorizedFoldersGlobAutomaton::IsPattern(InFolderName))
+			{
+				FolderNamePatterns.AddPattern(InFolderName, InSchemeIndex);
+			}
+			else
+			{
+				FolderNameToScheme.AddByHash(InHash, FString(InFolderName), InSchemeIndex);
+			}
+		}
+
+		/** Builds the automaton of all folder name patterns, after all folder names have been added. */
+		void CompilePatterns()
+		{
+			FolderNamePatterns.Compile();
+		}
+
+		/** Adds an explicit path (without trailing slash) along with its precomputed case-insensitive hash, overriding earlier schemes. Paths using glob syntax are added as path patterns. */
+		void AddExplicitPath(uint32 InHash, FStringView InExplicitPath, int32 InSchemeIndex)
+		{
+			if (FColorizedFoldersGlobAutomaton::IsPattern(InExplicitPath))
+			{
+				PathPatterns.AddPattern(InExplicitPath, InSchemeIndex);
+			}
+			else
+			{
+				ExplicitPathToScheme.AddByHash(InHash, FString(InExplicitPath), InSchemeIndex);
+			}
+		}
+
+		/**
+		 * Returns the index of the winning scheme for a folder, or INDEX_NONE. Case-insensitive.
+		 * @param InPath			Package path of the folder.
+		 * @param InVirtualPath		Optional Content Browser path of the folder, explicit paths may use either form.
+		 * @param InParentState		Optional path pattern state of the parent folder, so only the last segment has to be matched.
+		 * @param OutState			Optionally receives the path pattern state of this folder, to be passed on to its children.
+		 */
+		int32 Match(FStringView InPath, FStringView InVirtualPath = FStringView(),
+			const FColorizedFoldersPathState* InParentState = nullptr, FColorizedFoldersPathState* OutState = nullptr) const
+		{
+			// Children continue from this state, even if an explicit path wins for this folder
+			FColorizedFoldersPathState LocalState;
+			FColorizedFoldersPathState& PathState = OutState ? *OutState : LocalState;
+			ResolvePathState(InPath, InVirtualPath, InParentState, PathState);
+
+			int32 ExplicitIndex = MatchExplicitPath(InPath);
+			if (ExplicitIndex == INDEX_NONE && !InVirtualPath.IsEmpty() && InVirtualPath != InPath)
+			{
+				ExplicitIndex = MatchExplicitPath(InVirtualPath);
+			}
+
+			if (ExplicitIndex != INDEX_NONE)
+			{
+				return ExplicitIndex;
+			}
+
+			const int32 PatternIndex = PathPatterns.GetMatch(PathState);
+			if (PatternIndex != INDEX_NONE)
+			{
+				return PatternIndex;
+			}
+
+			int32 SlashIdx = INDEX_NONE;
+			InPath.FindLastChar(TEXT('/'), SlashIdx);
+			return MatchFolderName(InPath.RightChop(SlashIdx + 1));
+		}
+
+		/** Computes the path pattern state of a folder, either from its parent's state or by walking its whole path. */
+		void ResolvePathState(FStringView InPath, FStringView InVirtualPath, const FColorizedFoldersPathState* InParentState, FColorizedFoldersPathState& OutState) const
+		{
+			if (PathPatterns.IsEmpty())
+			{
+				OutState.Reset();
+				return;
+			}
+
+			if (InParentState)
+			{
+				int32 SlashIdx = INDEX_NONE;
+				InPath.FindLastChar(TEXT('/'), SlashIdx);
+				PathPatterns.Advance(*InParentState, InPath.RightChop(SlashIdx + 1), OutState);
+				return;
+			}
+
+			// Patterns may be written against either form of the path. Both forms only differ in their root, so children can continue from the combined state.
+			PathPatterns.Walk(InPath, OutState);
+			if (!InVirtualPath.IsEmpty() && InVirtualPath != InPath)
+			{
+				FColorizedFoldersPathState VirtualState;
+				PathPatterns.Walk(InVirtualPath, VirtualState);
+				OutState.Append(VirtualState);
+				OutState.Sort();
+				OutState.SetNum(Algo::Unique(OutState));
+			}
+		}
+
+		/** Returns the index of the scheme that explicitly lists this path, or INDEX_NONE. Case-insensitive. */
+		int32 MatchExplicitPath(FStringView InPath) const
+		{
+			const int32* SchemeIndex = ExplicitPathToScheme.FindByHash(GetTypeHash(InPath), InPath);
+			return SchemeIndex ? *SchemeIndex : INDEX_NONE;
+		}
+
+		/** Returns the index of the scheme matching the folder leaf name, or INDEX_NONE. Exact names win over patterns. Case-insensitive. */
+		int32 MatchFolderName(FStringView InLeafName) const
+		{
+			const int32* SchemeIndex = FolderNameToScheme.FindByHash(GetTypeHash(InLeafName), InLeafName);
+			return SchemeIndex ? *SchemeIndex : FolderNamePatterns.Match(InLeafName);
+		}
+
+		/** Returns all explicit paths along with the scheme that wins them. */
+		const TMap<FString, int32>& GetExplicitPaths() const
+		{
+			return ExplicitPathToScheme;
+		}
+
+		/** Returns true if no scheme has any folder names or explicit paths. */
+		bool IsEmpty() const
+		{
+			return FolderNameToScheme.IsEmpty() && ExplicitPathToScheme.IsEmpty() && FolderNamePatterns.IsEmpty() && PathPatterns.IsEmpty();
+		}
+
+	private:
+		/** Maps folder names to their scheme index. FString keys are hashed and compared case-insensitively. */
+		TMap<FString, int32> FolderNameToScheme;
+
+		/** Maps explicit paths (without trailing slash) to their scheme index. */
+		TMap<FString, int32> ExplicitPathToScheme;
+
+		/** Folder names using glob syntax, with the scheme index as their value. */
+		FColorizedFoldersGlobAutomaton FolderNamePatterns;
+
+		/** Explicit paths using glob syntax, with the scheme index as their value. */
+		FColorizedFoldersPathPatterns PathPatterns;
+	};
+}
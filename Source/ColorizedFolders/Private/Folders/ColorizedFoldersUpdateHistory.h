@@ -0,0 +1,71 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UE::ColorizedFolders
+{
+	/** What a folder color update had to do. */
+	enum class EColorizedFoldersUpdateKind : uint8
+	{
+		/** Installed the result of a full scan. */
+		Scan,
+
+		/** Matched and colored every folder in the index again. */
+		Full,
+
+		/** Only handled the folders that changed. */
+		Incremental,
+	};
+
+	/** Timings and counts of a single folder color update. */
+	struct FColorizedFoldersUpdateRecord
+	{
+		FDateTime Time;
+		EColorizedFoldersUpdateKind Kind = EColorizedFoldersUpdateKind::Incremental;
+
+		/** Wall time of the background scan, only set for scans. */
+		double ScanSeconds = 0.0;
+
+		/** Time spent on the game thread matching the dirty folders and applying their colors. */
+		double ApplySeconds = 0.0;
+
+		/** Number of folders in the index after the update. */
+		int32 NumFolders = 0;
+
+		/** Number of excluded folders the scan skipped along with their subtree, only set for scans. */
+		int32 NumPruned = 0;
+
+		/** Number of folder changes applied by this update. */
+		int32 NumDeltas = 0;
+
+		/** Number of folder colors written or cleared. */
+		uint64 NumWrites = 0;
+	};
+
+	/** Keeps the records of the most recent folder color updates, so they can be inspected from the console. */
+	class FColorizedFoldersUpdateHistory
+	{
+	public:
+		static constexpr int32 MaxRecords = 64;
+
+		void Add(const FColorizedFoldersUpdateRecord& InRecord)
+		{
+			if (Records.Num() == MaxRecords)
+			{
+				Records.RemoveAt(0, 1, EAllowShrinking::No);
+			}
+			Records.Add(InRecord);
+		}
+
+		/** Returns the records, oldest first. */
+		TConstArrayView<FColorizedFoldersUpdateRecord> GetRecords() const
+		{
+			return Records;
+		}
+
+	private:
+		TArray<FColorizedFoldersUpdateRecord> Records;
+	};
+}
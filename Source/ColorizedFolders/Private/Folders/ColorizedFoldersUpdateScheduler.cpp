@@ -0,0 +1,95 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "ColorizedFoldersUpdateScheduler.h"
+
+#include "ColorizedFoldersSettings.h"
+#include "ColorizedFoldersStats.h"
+
+namespace UE::ColorizedFolders
+{
+	FColorizedFoldersUpdateScheduler::~FColorizedFoldersUpdateScheduler()
+	{
+		Reset();
+	}
+
+	void FColorizedFoldersUpdateScheduler::AddDelta(FColorizedFoldersDelta&& InDelta)
+	{
+		Pending.Deltas.Add(MoveTemp(InDelta));
+		OnWorkAdded();
+	}
+
+	void FColorizedFoldersUpdateScheduler::RequestRematchAll()
+	{
+		Pending.bRematchAll = true;
+		OnWorkAdded();
+	}
+
+	void FColorizedFoldersUpdateScheduler::RequestRescan()
+	{
+		Pending.bRescan = true;
+		OnWorkAdded();
+	}
+
+	void FColorizedFoldersUpdateScheduler::Flush()
+	{
+		if (TickerHandle.IsValid())
+		{
+			FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+			TickerHandle.Reset();
+		}
+
+		if (!HasPendingWork())
+		{
+			return;
+		}
+
+		// Reset before calling out, so work queued by the callback ends up in the next flush
+		FColorizedFoldersPendingUpdate Update = MoveTemp(Pending);
+		Pending = FColorizedFoldersPendingUpdate();
+		OnFlush.ExecuteIfBound(MoveTemp(Update));
+	}
+
+	void FColorizedFoldersUpdateScheduler::Reset()
+	{
+		if (TickerHandle.IsValid())
+		{
+			FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+			TickerHandle.Reset();
+		}
+
+		Pending = FColorizedFoldersPendingUpdate();
+	}
+
+	void FColorizedFoldersUpdateScheduler::OnWorkAdded()
+	{
+		LastRequestTime = FPlatformTime::Seconds();
+		if (!TickerHandle.IsValid())
+		{
+			FirstRequestTime = LastRequestTime;
+			TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FColorizedFoldersUpdateScheduler::Tick));
+		}
+		else
+		{
+			// Joins the update that is already pending
+			INC_DWORD_STAT(STAT_ColorizedFolders_RequestsCoalesced);
+		}
+	}
+
+	bool FColorizedFoldersUpdateScheduler::Tick(float DeltaTime)
+	{
+		const UColorizedFoldersSettings* Settings = UColorizedFoldersSettings::Get();
+		const double Now = FPlatformTime::Seconds();
+
+		// Keep waiting while changes are still coming in, but don't let a steady stream of changes starve the update
+		if (Now - LastRequestTime < Settings->UpdateQuietPeriod && Now - FirstRequestTime < Settings->MaxUpdateDelay)
+		{
+			return true;
+		}
+
+		// Returning false removes the ticker, so don't let Flush() remove it as well
+		TickerHandle.Reset();
+		Flush();
+		return false;
+	}
+}
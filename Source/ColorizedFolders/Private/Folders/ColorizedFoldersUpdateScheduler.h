@@ -0,0 +1,79 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ColorizedFoldersIndex.h"
+#include "Containers/Ticker.h"
+
+namespace UE::ColorizedFolders
+{
+	/** All work collected by the update scheduler since its last flush. */
+	struct FColorizedFoldersPendingUpdate
+	{
+		/** Folder changes in the order they were reported. */
+		TArray<FColorizedFoldersDelta> Deltas;
+
+		/** Whether all folders have to be matched again, e.g. because the theme changed. */
+		bool bRematchAll = false;
+
+		/** Whether the content directories have to be scanned again. */
+		bool bRescan = false;
+	};
+
+	/**
+	 * Collects folder changes and update requests into a single pending update, which is flushed once
+	 * no new work came in for the configured quiet period, or once the oldest work has waited for the maximum delay.
+	 * Bulk operations like imports, moves of whole folder trees or source control syncs report lots of small batches,
+	 * which this turns into a single update.
+	 */
+	class FColorizedFoldersUpdateScheduler
+	{
+	public:
+		DECLARE_DELEGATE_OneParam(FOnFlush, FColorizedFoldersPendingUpdate&& /*PendingUpdate*/);
+
+		~FColorizedFoldersUpdateScheduler();
+
+		/** Sets the callback that receives the coalesced work. Called on the game thread. */
+		void SetOnFlush(FOnFlush&& InOnFlush)
+		{
+			OnFlush = MoveTemp(InOnFlush);
+		}
+
+		/** Queues a folder change. */
+		void AddDelta(FColorizedFoldersDelta&& InDelta);
+
+		/** Queues matching all folders again, without scanning the disk. */
+		void RequestRematchAll();
+
+		/** Queues a full rescan of the content directories. */
+		void RequestRescan();
+
+		/** Hands all pending work to the flush callback right away. */
+		void Flush();
+
+		/** Drops all pending work without flushing it. */
+		void Reset();
+
+		/** Returns true if there is work waiting to be flushed. */
+		bool HasPendingWork() const
+		{
+			return !Pending.Deltas.IsEmpty() || Pending.bRematchAll || Pending.bRescan;
+		}
+
+	private:
+		/** Remembers when work came in and makes sure the ticker is running. */
+		void OnWorkAdded();
+
+		bool Tick(float DeltaTime);
+
+		FColorizedFoldersPendingUpdate Pending;
+		FOnFlush OnFlush;
+
+		FTSTicker::FDelegateHandle TickerHandle;
+
+		/** Time at which the oldest and the latest pending work came in. */
+		double FirstRequestTime = 0.0;
+		double LastRequestTime = 0.0;
+	};
+}
@@ -0,0 +1,143 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "Folders/ColorizedFoldersGlobAutomaton.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UE::ColorizedFolders::Private
+{
+	/** Returns the highest value of all patterns matching the name, using FString::MatchesWildcard() as reference. Only supports '*' and '?'. */
+	int32 MatchWildcards(TConstArrayView<FString> InPatterns, const FString& InName)
+	{
+		int32 Value = INDEX_NONE;
+		for (int32 PatternIdx = 0; PatternIdx < InPatterns.Num(); ++PatternIdx)
+		{
+			if (InName.MatchesWildcard(InPatterns[PatternIdx], ESearchCase::IgnoreCase))
+			{
+				Value = FMath::Max(Value, PatternIdx);
+			}
+		}
+		return Value;
+	}
+
+	FColorizedFoldersGlobAutomaton CompileAutomaton(TConstArrayView<FString> InPatterns)
+	{
+		FColorizedFoldersGlobAutomaton Automaton;
+		for (int32 PatternIdx = 0; PatternIdx < InPatterns.Num(); ++PatternIdx)
+		{
+			Automaton.AddPattern(InPatterns[PatternIdx], PatternIdx);
+		}
+		Automaton.Compile();
+		return Automaton;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FColorizedFoldersGlobAutomatonTest, "ColorizedFolders.GlobAutomaton",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FColorizedFoldersGlobAutomatonTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::ColorizedFolders;
+	using namespace UE::ColorizedFolders::Private;
+
+	// Stars and single characters
+	{
+		const FString Patterns[] = { TEXT("Char*"), TEXT("*_Old"), TEXT("T?x"), TEXT("*") };
+		const FColorizedFoldersGlobAutomaton Automaton = CompileAutomaton(Patterns);
+		TestFalse(TEXT("Few patterns are turned into a DFA"), Automaton.IsUsingNfa());
+
+		TestEqual(TEXT("'*' matches any suffix"), Automaton.Match(TEXT("Characters")), 3);
+		TestEqual(TEXT("'*' matches an empty suffix"), Automaton.Match(TEXT("Char")), 3);
+		TestEqual(TEXT("'?' matches a single character"), Automaton.Match(TEXT("Tex")), 3);
+		TestEqual(TEXT("A lone '*' matches everything"), Automaton.Match(TEXT("Tesx")), 3);
+		TestEqual(TEXT("A lone '*' matches the empty name"), Automaton.Match(TEXT("")), 3);
+	}
+	{
+		const FString Patterns[] = { TEXT("Char*"), TEXT("*_Old"), TEXT("T?x") };
+		const FColorizedFoldersGlobAutomaton Automaton = CompileAutomaton(Patterns);
+
+		TestEqual(TEXT("Prefix pattern"), Automaton.Match(TEXT("Characters")), 0);
+		TestEqual(TEXT("Suffix pattern"), Automaton.Match(TEXT("Maps_Old")), 1);
+		TestEqual(TEXT("The highest value wins"), Automaton.Match(TEXT("Char_Old")), 1);
+		TestEqual(TEXT("'?' doesn't match two characters"), Automaton.Match(TEXT("Tesx")), INDEX_NONE);
+		TestEqual(TEXT("'?' doesn't match no character"), Automaton.Match(TEXT("Tx")), INDEX_NONE);
+		TestEqual(TEXT("Patterns cover the whole name"), Automaton.Match(TEXT("MyCharacters")), INDEX_NONE);
+	}
+
+	// Case-insensitivity
+	{
+		const FString Patterns[] = { TEXT("UI_*"), TEXT("[A-C]x") };
+		const FColorizedFoldersGlobAutomaton Automaton = CompileAutomaton(Patterns);
+
+		TestEqual(TEXT("Lowercase name"), Automaton.Match(TEXT("ui_widgets")), 0);
+		TestEqual(TEXT("Mixed case name"), Automaton.Match(TEXT("Ui_Widgets")), 0);
+		TestEqual(TEXT("Ranges are case-insensitive"), Automaton.Match(TEXT("bX")), 1);
+	}
+
+	// Character classes
+	{
+		const FString Patterns[] = { TEXT("Lvl[0-9]"), TEXT("[abc]_*"), TEXT("[!x]y"), TEXT("[^x]z"), TEXT("[]]q"), TEXT("[no") };
+		const FColorizedFoldersGlobAutomaton Automaton = CompileAutomaton(Patterns);
+
+		TestEqual(TEXT("Range"), Automaton.Match(TEXT("Lvl7")), 0);
+		TestEqual(TEXT("Outside of the range"), Automaton.Match(TEXT("LvlA")), INDEX_NONE);
+		TestEqual(TEXT("A set only matches a single character"), Automaton.Match(TEXT("Lvl10")), INDEX_NONE);
+		TestEqual(TEXT("Set"), Automaton.Match(TEXT("b_Meshes")), 1);
+		TestEqual(TEXT("Outside of the set"), Automaton.Match(TEXT("d_Meshes")), INDEX_NONE);
+		TestEqual(TEXT("'!' negates the set"), Automaton.Match(TEXT("ay")), 2);
+		TestEqual(TEXT("'!' excludes the set"), Automaton.Match(TEXT("xy")), INDEX_NONE);
+		TestEqual(TEXT("'^' negates the set"), Automaton.Match(TEXT("az")), 3);
+		TestEqual(TEXT("'^' excludes the set"), Automaton.Match(TEXT("Xz")), INDEX_NONE);
+		TestEqual(TEXT("A leading ']' is part of the set"), Automaton.Match(TEXT("]q")), 4);
+		TestEqual(TEXT("An unterminated '[' is a literal character"), Automaton.Match(TEXT("[no")), 5);
+	}
+
+	// DFA and NFA agree with each other and with MatchesWildcard()
+	{
+		const FString Patterns[] = { TEXT("*a?b*"), TEXT("B*"), TEXT("?a*a"), TEXT("ab") };
+
+		// Remembering which of the last 16 characters were an 'a' takes far more than MaxDfaStates states
+		TArray<FString> NfaPatterns;
+		NfaPatterns.Add(TEXT("*a????????????????"));
+		NfaPatterns.Append(Patterns, UE_ARRAY_COUNT(Patterns));
+
+		const FColorizedFoldersGlobAutomaton Dfa = CompileAutomaton(Patterns);
+		const FColorizedFoldersGlobAutomaton Nfa = CompileAutomaton(NfaPatterns);
+		TestFalse(TEXT("Simple patterns are turned into a DFA"), Dfa.IsUsingNfa());
+		TestTrue(TEXT("Exponential patterns fall back to the NFA"), Nfa.IsUsingNfa());
+
+		static constexpr TCHAR Alphabet[] = TEXT("aAbBc");
+		FRandomStream Random(0x636f6c6f);
+		for (int32 Iteration = 0; Iteration < 2000; ++Iteration)
+		{
+			FString Name;
+			const int32 Len = Random.RandRange(0, 24);
+			for (int32 CharIdx = 0; CharIdx < Len; ++CharIdx)
+			{
+				Name.AppendChar(Alphabet[Random.RandRange(0, static_cast<int32>(UE_ARRAY_COUNT(Alphabet)) - 2)]);
+			}
+
+			const int32 Expected = MatchWildcards(Patterns, Name);
+			const int32 ExpectedNfa = MatchWildcards(NfaPatterns, Name);
+			if (!TestEqual(FString::Printf(TEXT("DFA matches '%s'"), *Name), Dfa.Match(Name), Expected) ||
+				!TestEqual(FString::Printf(TEXT("NFA matches '%s'"), *Name), Nfa.Match(Name), ExpectedNfa))
+			{
+				break;
+			}
+
+			// Both hold the same patterns, the NFA's ones just have their value shifted by the extra pattern
+			if (ExpectedNfa != 0)
+			{
+				const int32 DfaValue = Dfa.Match(Name);
+				TestEqual(FString::Printf(TEXT("DFA and NFA agree on '%s'"), *Name), Nfa.Match(Name), DfaValue == INDEX_NONE ? INDEX_NONE : DfaValue + 1);
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
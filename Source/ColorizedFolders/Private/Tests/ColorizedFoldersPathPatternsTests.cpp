@@ -0,0 +1,82 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "Folders/ColorizedFoldersPathPatterns.h"
+#include "Folders/ColorizedFoldersPathTrie.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FColorizedFoldersPathPatternsTest, "ColorizedFolders.PathPatterns",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FColorizedFoldersPathPatternsTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::ColorizedFolders;
+
+	FColorizedFoldersPathPatterns Patterns;
+	Patterns.AddPattern(TEXT("**/Art"), 0);
+	Patterns.AddPattern(TEXT("/Game/**/Textures"), 1);
+	Patterns.AddPattern(TEXT("/Game/Characters/**"), 2);
+	Patterns.AddPattern(TEXT("/Game/Maps/*_Old"), 3);
+	Patterns.AddPattern(TEXT("/Game/[A-C]*/Meshes"), 4);
+	Patterns.AddPattern(TEXT("/Game/**/UI/**/Icons"), 5);
+
+	auto Match = [&Patterns](FStringView Path)
+	{
+		FColorizedFoldersPathState State;
+		Patterns.Walk(Path, State);
+		return Patterns.GetMatch(State);
+	};
+
+	// "**" at the start
+	TestEqual(TEXT("Leading '**' matches no folder"), Match(TEXT("/Art")), 0);
+	TestEqual(TEXT("Leading '**' matches a single folder"), Match(TEXT("/Game/Art")), 0);
+	TestEqual(TEXT("Leading '**' matches many folders"), Match(TEXT("/MyPlugin/Environment/Desert/Art")), 0);
+	TestEqual(TEXT("Leading '**' doesn't match below the pattern"), Match(TEXT("/Game/Art/Rocks")), INDEX_NONE);
+
+	// "**" in the middle
+	TestEqual(TEXT("Inner '**' matches no folder"), Match(TEXT("/Game/Textures")), 1);
+	TestEqual(TEXT("Inner '**' matches many folders"), Match(TEXT("/Game/Environment/Desert/Textures")), 1);
+	TestEqual(TEXT("Inner '**' keeps the prefix"), Match(TEXT("/MyPlugin/Textures")), INDEX_NONE);
+	TestEqual(TEXT("Two inner '**' match no folders"), Match(TEXT("/Game/UI/Icons")), 5);
+	TestEqual(TEXT("Two inner '**' match many folders"), Match(TEXT("/Game/Menus/UI/Main/Buttons/Icons")), 5);
+	TestEqual(TEXT("Two inner '**' keep the segment between them"), Match(TEXT("/Game/Menus/Icons")), INDEX_NONE);
+
+	// "**" at the end
+	TestEqual(TEXT("Trailing '**' matches the folder itself"), Match(TEXT("/Game/Characters")), 2);
+	TestEqual(TEXT("Trailing '**' matches every subfolder"), Match(TEXT("/Game/Characters/Hero/Animations")), 2);
+	TestEqual(TEXT("The highest value wins"), Match(TEXT("/Game/Characters/Hero/Art")), 2);
+	TestEqual(TEXT("Trailing '**' keeps the prefix"), Match(TEXT("/Game/Props")), INDEX_NONE);
+
+	// Glob segments only match a single folder
+	TestEqual(TEXT("Glob segment"), Match(TEXT("/Game/Maps/Desert_Old")), 3);
+	TestEqual(TEXT("Glob segment doesn't span folders"), Match(TEXT("/Game/Maps/Desert/Level_Old")), INDEX_NONE);
+	TestEqual(TEXT("Character class segment"), Match(TEXT("/Game/Buildings/Meshes")), 4);
+	TestEqual(TEXT("Outside of the character class"), Match(TEXT("/Game/Props/Meshes")), INDEX_NONE);
+
+	// Case-insensitivity
+	TestEqual(TEXT("Literal segments ignore case"), Match(TEXT("/game/CHARACTERS/hero")), 2);
+	TestEqual(TEXT("'**' patterns ignore case"), Match(TEXT("/GAME/environment/TEXTURES")), 1);
+	TestEqual(TEXT("Glob segments ignore case"), Match(TEXT("/Game/maps/DESERT_OLD")), 3);
+
+	// Advancing a folder's state from its parent's gives the same result as walking the whole path
+	const TCHAR* Paths[] = { TEXT("/Game/Characters/Hero/Art"), TEXT("/Game/Menus/UI/Main/Icons"), TEXT("/Game/Maps/Desert_Old"), TEXT("/MyPlugin/Art") };
+	for (const TCHAR* Path : Paths)
+	{
+		FColorizedFoldersPathState State;
+		FColorizedFoldersPathState NextState;
+		Patterns.GetRootState(State);
+		FColorizedFoldersPathTrie::ForEachSegment(Path, [&Patterns, &State, &NextState](FStringView Segment)
+		{
+			Patterns.Advance(State, Segment, NextState);
+			Swap(State, NextState);
+			return true;
+		});
+		TestEqual(FString::Printf(TEXT("Advance matches Walk for '%s'"), Path), Patterns.GetMatch(State), Match(Path));
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,325 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+
+#include "ColorizedFoldersCompiledTheme.h"
+
+#include "ColorizedFoldersTheme.h"
+#include "Async/MappedFileHandle.h"
+#include "Folders/ColorizedFoldersSchemeMatcher.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+
+namespace UE::ColorizedFolders::Private
+{
+	/** "CFTB" */
+	constexpr uint32 CompiledThemeMagic = 0x42544643;
+
+	/** Bump whenever the layout changes, older files are ignored and the JSON file is used instead. */
+	constexpr uint32 CompiledThemeVersion = 3;
+
+	/** Hashed when writing and reading, so files written by an engine with a different string hash are rejected. */
+	constexpr FStringView HashProbe = TEXTVIEW("ColorizedFolders");
+
+	/** Followed by the schemes, the string references, the string table and the characters, in that order. */
+	struct FCompiledThemeHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		int64 SourceTimestamp;
+		FGuid Id;
+		uint32 CharSize;
+		uint32 HashProbe;
+		uint32 DisplayName;
+		uint32 NumSchemes;
+		uint32 NumReferences;
+		uint32 NumStrings;
+		uint32 NumChars;
+		uint32 Padding;
+	};
+	static_assert(sizeof(FCompiledThemeHeader) == 64);
+
+	struct FCompiledScheme
+	{
+		FLinearColor Color;
+
+		/** Ranges in the string references. */
+		uint32 FirstFolderName;
+		uint32 NumFolderNames;
+		uint32 FirstExplicitPath;
+		uint32 NumExplicitPaths;
+
+		/** See FColorizedFolderColorScheme. */
+		uint32 bInheritToChildren;
+		int32 InheritDepth;
+		float InheritDesaturation;
+		uint32 Padding;
+	};
+	static_assert(sizeof(FCompiledScheme) == 48);
+
+	struct FCompiledString
+	{
+		/** Range in the characters. */
+		uint32 Offset;
+		uint32 Len;
+
+		/** Case-insensitive hash, as used by the scheme matcher. */
+		uint32 Hash;
+	};
+
+	/** Deduplicates strings while writing a compiled theme. */
+	struct FStringTableBuilder
+	{
+		/** Returns the index of the string, adding it if no equal string has been added yet. Case-sensitive, so every spelling round-trips. */
+		uint32 Intern(const FString& InString)
+		{
+			for (auto It = StringToIndex.CreateConstKeyIterator(InString); It; ++It)
+			{
+				if (GetString(It.Value()).Equals(InString, ESearchCase::CaseSensitive))
+				{
+					return It.Value();
+				}
+			}
+
+			const uint32 Index = Add(InString);
+			StringToIndex.Add(InString, Index);
+			return Index;
+		}
+
+		/** Adds a string without deduplicating it. */
+		uint32 Add(FStringView InString)
+		{
+			const uint32 Index = Strings.Num();
+			Strings.Add({ static_cast<uint32>(Chars.Num()), static_cast<uint32>(InString.Len()), GetTypeHash(InString) });
+			Chars.Append(InString.GetData(), InString.Len());
+			return Index;
+		}
+
+		FStringView GetString(uint32 InIndex) const
+		{
+			return FStringView(Chars.GetData() + Strings[InIndex].Offset, Strings[InIndex].Len);
+		}
+
+		/** FString keys are hashed and compared case-insensitively, so strings that only differ in case share a key. */
+		TMultiMap<FString, uint32> StringToIndex;
+
+		TArray<FCompiledString> Strings;
+		TArray<TCHAR> Chars;
+	};
+
+	/** Splits a comma separated list the same way FColorizedFoldersSchemeMatcher::Compile() does. */
+	template <typename VisitorType>
+	void ForEachListEntry(const FString& InList, bool bIsPath, VisitorType&& Visitor)
+	{
+		TArray<FString> Entries;
+		InList.ParseIntoArray(Entries, TEXT(","), true);
+		for (FString& Entry : Entries)
+		{
+			Entry.TrimStartAndEndInline();
+			if (bIsPath)
+			{
+				Entry.RemoveFromEnd(TEXT("/"));
+			}
+
+			if (!Entry.IsEmpty())
+			{
+				Visitor(Entry);
+			}
+		}
+	}
+}
+
+namespace UE::ColorizedFolders
+{
+	FString FColorizedFoldersCompiledTheme::GetCompiledFilename(const FString& InThemeFilename)
+	{
+		return FPaths::ChangeExtension(InThemeFilename, TEXT("cftheme"));
+	}
+
+	FString FColorizedFoldersCompiledTheme::GetCachedCompiledFilename(const FString& InThemeFilename)
+	{
+		// Themes of different directories may share a file name
+		FString FullFilename = FPaths::ConvertRelativePathToFull(InThemeFilename);
+		FPaths::NormalizeFilename(FullFilename);
+		const uint32 PathHash = FCrc::StrCrc32(*FullFilename.ToLower());
+
+		return FPaths::ProjectIntermediateDir() / TEXT("ColorizedFolders/Themes") / FString::Printf(TEXT("%s-%08x.cftheme"), *FPaths::GetBaseFilename(InThemeFilename), PathHash);
+	}
+
+	bool FColorizedFoldersCompiledTheme::Write(const FString& InFilename, const FColorizedFolderTheme& InTheme, TConstArrayView<FColorizedFolderColorScheme> InSchemes, const FDateTime& InSourceTimestamp)
+	{
+		using namespace Private;
+
+		FStringTableBuilder StringTable;
+		TArray<FCompiledScheme> Schemes;
+		TArray<uint32> References;
+
+		// Keep the display name exactly as it was written
+		const uint32 DisplayName = StringTable.Add(InTheme.DisplayName.ToString());
+		for (const FColorizedFolderColorScheme& Scheme : InSchemes)
+		{
+			FCompiledScheme& CompiledScheme = Schemes.AddZeroed_GetRef();
+			CompiledScheme.Color = Scheme.SchemeColor;
+			CompiledScheme.bInheritToChildren = Scheme.bInheritToChildren ? 1 : 0;
+			CompiledScheme.InheritDepth = Scheme.InheritDepth;
+			CompiledScheme.InheritDesaturation = Scheme.InheritDesaturation;
+
+			CompiledScheme.FirstFolderName = References.Num();
+			ForEachListEntry(Scheme.FolderNames, false, [&](const FString& FolderName)
+			{
+				References.Add(StringTable.Intern(FolderName));
+			});
+			CompiledScheme.NumFolderNames = References.Num() - CompiledScheme.FirstFolderName;
+
+			CompiledScheme.FirstExplicitPath = References.Num();
+			ForEachListEntry(Scheme.ExplicitPaths, true, [&](const FString& ExplicitPath)
+			{
+				References.Add(StringTable.Intern(ExplicitPath));
+			});
+			CompiledScheme.NumExplicitPaths = References.Num() - CompiledScheme.FirstExplicitPath;
+		}
+
+		FCompiledThemeHeader Header;
+		FMemory::Memzero(Header);
+		Header.Magic = CompiledThemeMagic;
+		Header.Version = CompiledThemeVersion;
+		Header.SourceTimestamp = InSourceTimestamp.GetTicks();
+		Header.Id = InTheme.Id;
+		Header.CharSize = sizeof(TCHAR);
+		Header.HashProbe = GetTypeHash(HashProbe);
+		Header.DisplayName = DisplayName;
+		Header.NumSchemes = Schemes.Num();
+		Header.NumReferences = References.Num();
+		Header.NumStrings = StringTable.Strings.Num();
+		Header.NumChars = StringTable.Chars.Num();
+
+		TArray<uint8> Data;
+		Data.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+		Data.Append(reinterpret_cast<const uint8*>(Schemes.GetData()), Schemes.NumBytes());
+		Data.Append(reinterpret_cast<const uint8*>(References.GetData()), References.NumBytes());
+		Data.Append(reinterpret_cast<const uint8*>(StringTable.Strings.GetData()), StringTable.Strings.NumBytes());
+		Data.Append(reinterpret_cast<const uint8*>(StringTable.Chars.GetData()), StringTable.Chars.NumBytes());
+
+		return FFileHelper::SaveArrayToFile(Data, *InFilename);
+	}
+
+	bool FColorizedFoldersCompiledTheme::Read(const FString& InFilename, const FDateTime& InSourceTimestamp, FColorizedFolderTheme& OutTheme, FColorizedFoldersSchemeMatcher& OutMatcher)
+	{
+		using namespace Private;
+
+		// Map the file if the platform supports it, otherwise read it in one go
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		TUniquePtr<IMappedFileHandle> MappedFile(PlatformFile.FileExists(*InFilename) ? PlatformFile.OpenMapped(*InFilename) : nullptr);
+		TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile ? MappedFile->MapRegion() : nullptr);
+
+		TArray<uint8> LoadedData;
+		TConstArrayView<uint8> Data;
+		if (MappedRegion)
+		{
+			Data = MakeArrayView(MappedRegion->GetMappedPtr(), static_cast<int32>(MappedRegion->GetMappedSize()));
+		}
+		else if (FFileHelper::LoadFileToArray(LoadedData, *InFilename, FILEREAD_Silent))
+		{
+			Data = LoadedData;
+		}
+
+		if (Data.Num() < static_cast<int32>(sizeof(FCompiledThemeHeader)))
+		{
+			return false;
+		}
+
+		FCompiledThemeHeader Header;
+		FMemory::Memcpy(&Header, Data.GetData(), sizeof(Header));
+		if (Header.Magic != CompiledThemeMagic ||
+			Header.Version != CompiledThemeVersion ||
+			Header.SourceTimestamp != InSourceTimestamp.GetTicks() ||
+			Header.CharSize != sizeof(TCHAR) ||
+			Header.HashProbe != GetTypeHash(HashProbe) ||
+			Header.NumSchemes > NUM_FOLDER_SCHEMES)
+		{
+			return false;
+		}
+
+		// All sections are multiples of four bytes, so they are properly aligned in the mapped file
+		const uint64 SchemesOffset = sizeof(FCompiledThemeHeader);
+		const uint64 ReferencesOffset = SchemesOffset + uint64(Header.NumSchemes) * sizeof(FCompiledScheme);
+		const uint64 StringsOffset = ReferencesOffset + uint64(Header.NumReferences) * sizeof(uint32);
+		const uint64 CharsOffset = StringsOffset + uint64(Header.NumStrings) * sizeof(FCompiledString);
+		const uint64 EndOffset = CharsOffset + uint64(Header.NumChars) * sizeof(TCHAR);
+		if (EndOffset != uint64(Data.Num()) || Header.DisplayName >= Header.NumStrings)
+		{
+			return false;
+		}
+
+		const FCompiledScheme* Schemes = reinterpret_cast<const FCompiledScheme*>(Data.GetData() + SchemesOffset);
+		const uint32* References = reinterpret_cast<const uint32*>(Data.GetData() + ReferencesOffset);
+		const FCompiledString* Strings = reinterpret_cast<const FCompiledString*>(Data.GetData() + StringsOffset);
+		const TCHAR* Chars = reinterpret_cast<const TCHAR*>(Data.GetData() + CharsOffset);
+
+		for (uint32 StringIdx = 0; StringIdx < Header.NumStrings; ++StringIdx)
+		{
+			if (uint64(Strings[StringIdx].Offset) + Strings[StringIdx].Len > Header.NumChars)
+			{
+				return false;
+			}
+		}
+
+		for (uint32 ReferenceIdx = 0; ReferenceIdx < Header.NumReferences; ++ReferenceIdx)
+		{
+			if (References[ReferenceIdx] >= Header.NumStrings)
+			{
+				return false;
+			}
+		}
+
+		auto GetString = [Strings, Chars](uint32 StringIdx)
+		{
+			return FStringView(Chars + Strings[StringIdx].Offset, Strings[StringIdx].Len);
+		};
+
+		OutTheme.Id = Header.Id;
+		OutTheme.DisplayName = FText::FromString(FString(GetString(Header.DisplayName)));
+		if (OutTheme.LoadedDefaultColorSchemes.Num() < NUM_FOLDER_SCHEMES)
+		{
+			OutTheme.LoadedDefaultColorSchemes.SetNum(NUM_FOLDER_SCHEMES);
+		}
+		OutMatcher.Reset();
+
+		for (uint32 SchemeIdx = 0; SchemeIdx < Header.NumSchemes; ++SchemeIdx)
+		{
+			const FCompiledScheme& CompiledScheme = Schemes[SchemeIdx];
+			if (uint64(CompiledScheme.FirstFolderName) + CompiledScheme.NumFolderNames > Header.NumReferences ||
+				uint64(CompiledScheme.FirstExplicitPath) + CompiledScheme.NumExplicitPaths > Header.NumReferences)
+			{
+				return false;
+			}
+
+			FColorizedFolderColorScheme& Scheme = OutTheme.LoadedDefaultColorSchemes[SchemeIdx];
+			Scheme.SchemeColor = CompiledScheme.Color;
+			Scheme.bInheritToChildren = CompiledScheme.bInheritToChildren != 0;
+			Scheme.InheritDepth = CompiledScheme.InheritDepth;
+			Scheme.InheritDesaturation = CompiledScheme.InheritDesaturation;
+
+			// The schemes keep the comma separated lists for the theme editor, the matcher gets the interned strings with their hash
+			TStringBuilder<256> FolderNames;
+			for (uint32 RefIdx = CompiledScheme.FirstFolderName; RefIdx < CompiledScheme.FirstFolderName + CompiledScheme.NumFolderNames; ++RefIdx)
+			{
+				const FStringView FolderName = GetString(References[RefIdx]);
+				FolderNames << (FolderNames.Len() > 0 ? TEXT(",") : TEXT("")) << FolderName;
+				OutMatcher.AddFolderName(Strings[References[RefIdx]].Hash, FolderName, SchemeIdx);
+			}
+			Scheme.FolderNames = FString(FolderNames.ToView());
+
+			TStringBuilder<256> ExplicitPaths;
+			for (uint32 RefIdx = CompiledScheme.FirstExplicitPath; RefIdx < CompiledScheme.FirstExplicitPath + CompiledScheme.NumExplicitPaths; ++RefIdx)
+			{
+				const FStringView ExplicitPath = GetString(References[RefIdx]);
+				ExplicitPaths << (ExplicitPaths.Len() > 0 ? TEXT(",") : TEXT("")) << ExplicitPath;
+				OutMatcher.AddExplicitPath(Strings[References[RefIdx]].Hash, ExplicitPath, SchemeIdx);
+			}
+			Scheme.ExplicitPaths = FString(ExplicitPaths.ToView());
+		}
+
+		OutMatcher.CompilePatterns();
+		return true;
+	}
+}
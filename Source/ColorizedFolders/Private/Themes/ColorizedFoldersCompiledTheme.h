@@ -0,0 +1,48 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FColorizedFolderColorScheme;
+struct FColorizedFolderTheme;
+
+namespace UE::ColorizedFolders
+{
+	class FColorizedFoldersSchemeMatcher;
+
+	/**
+	 * Binary form of a theme, stored next to its JSON file. The JSON file stays the editable source of truth,
+	 * the compiled file is only used as long as it's newer than the JSON file it was compiled from.
+	 *
+	 * Folder names and explicit paths are interned into a single string table along with their precomputed hash,
+	 * and colors are stored as packed floats. Reading maps the file and copies the strings into the schemes and the matcher,
+	 * without tokenizing any JSON or hashing any string again.
+	 */
+	class FColorizedFoldersCompiledTheme
+	{
+	public:
+		/** Returns the compiled file that belongs to a JSON theme file, as written when the theme is saved. */
+		static FString GetCompiledFilename(const FString& InThemeFilename);
+
+		/**
+		 * Returns the compiled file that caches a JSON theme file that has been loaded, below the project's intermediate dir.
+		 * Theme directories may be read-only or under source control, so compiled files are only written next to the themes we save ourselves.
+		 */
+		static FString GetCachedCompiledFilename(const FString& InThemeFilename);
+
+		/**
+		 * Writes the compiled form of a theme.
+		 * @param InSourceTimestamp		Modification time of the JSON file the theme has been saved to.
+		 */
+		static bool Write(const FString& InFilename, const FColorizedFolderTheme& InTheme, TConstArrayView<FColorizedFolderColorScheme> InSchemes, const FDateTime& InSourceTimestamp);
+
+		/**
+		 * Reads a compiled theme, unless it's outdated or has been written by an incompatible version.
+		 * @param InSourceTimestamp		Current modification time of the JSON file, the compiled file is rejected if it doesn't match.
+		 * @param OutTheme				Receives the id, display name and schemes of the theme. Schemes missing from the file keep their value.
+		 * @param OutMatcher			Receives the compiled lookup of the schemes, without hashing any of the strings again.
+		 */
+		static bool Read(const FString& InFilename, const FDateTime& InSourceTimestamp, FColorizedFolderTheme& OutTheme, FColorizedFoldersSchemeMatcher& OutMatcher);
+	};
+}
@@ -3,6 +3,11 @@
 
 #include "ColorizedFoldersManager.h"
 
+#include "ColorizedFoldersCompiledTheme.h"
+#include "ColorizedFoldersStats.h"
+#include "ColorizedFoldersTrace.h"
+#include "DirectoryWatcherModule.h"
+#include "IDirectoryWatcher.h"
 #include "Interfaces/IPluginManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(ColorizedFoldersManager)
@@ -37,13 +42,19 @@ void UColorizedFoldersManager::SetDefaultTheme(int32 Id, FColorizedFolderColorSc
 #if ALLOW_THEMES
 void UColorizedFoldersManager::LoadThemes()
 {
+	SCOPE_CYCLE_COUNTER(STAT_ColorizedFolders_LoadThemes);
+	COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::LoadThemes");
+
 	LoadedThemes.Empty();
+	RebuildThemeLookups();
+	CompiledThemes.Empty();
 
 	// Load themes from engine, project, and user directories
-	LoadThemesFromDirectory(GetPluginThemeDir());
-	LoadThemesFromDirectory(GetEngineThemeDir());
-	LoadThemesFromDirectory(GetProjectThemeDir());
-	LoadThemesFromDirectory(GetUserThemeDir());
+	LoadThemesFromDirectory(GetPluginThemeDir(), EColorizedFolderThemeOrigin::Plugin);
+	LoadThemesFromDirectory(GetEngineThemeDir(), EColorizedFolderThemeOrigin::Engine);
+	LoadThemesFromDirectory(GetProjectThemeDir(), EColorizedFolderThemeOrigin::Project);
+	LoadThemesFromDirectory(GetUserThemeDir(), EColorizedFolderThemeOrigin::User);
+	WatchThemeDirectories();
 
 	EnsureValidCurrentTheme();
 	ApplyTheme(CurrentThemeId);
@@ -73,6 +84,11 @@ void UColorizedFoldersManager::SaveCurrentThemeAs(const FString& InFilename)
 				{ // Scheme Color
 					Writer.WriteValue(TEXT("SchemeColor"), Scheme.SchemeColor.ToString());
 				}
+				{ // Inheritance
+					Writer.WriteValue(TEXT("InheritToChildren"), Scheme.bInheritToChildren);
+					Writer.WriteValue(TEXT("InheritDepth"), Scheme.InheritDepth);
+					Writer.WriteValue(TEXT("InheritDesaturation"), Scheme.InheritDesaturation);
+				}
 				{ // Folder Names
 					Writer.WriteArrayStart(TEXT("FolderNames"));
 					for (const FString& FolderName : Scheme.ResolveFolderNames())
@@ -113,39 +129,48 @@ void UColorizedFoldersManager::SaveCurrentThemeAs(const FString& InFilename)
 
 		FFileHelper::SaveStringToFile(Output, *NewPath);
 	}
+
+	// Keep the parsed schemes in sync with the file, so applying the theme again doesn't need to read it
+	CurrentTheme.LoadedDefaultColorSchemes = MakeArrayView<FColorizedFolderColorScheme>(ActiveSchemes.Schemes, NUM_FOLDER_SCHEMES);
+	CompiledThemes.Remove(CurrentTheme.Id);
+
+	// Save the compiled theme next to the JSON file, which is what gets loaded from now on
+	UE::ColorizedFolders::FColorizedFoldersCompiledTheme::Write(UE::ColorizedFolders::FColorizedFoldersCompiledTheme::GetCompiledFilename(NewPath),
+		CurrentTheme, MakeArrayView(ActiveSchemes.Schemes), IFileManager::Get().GetTimeStamp(*NewPath));
 }
 
 void UColorizedFoldersManager::ApplyTheme(FGuid ThemeId)
 {
+	SCOPE_CYCLE_COUNTER(STAT_ColorizedFolders_ApplyTheme);
+	COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::ApplyTheme");
+
 	if (ThemeId.IsValid())
 	{
-		FColorizedFolderTheme* CurrentTheme;
 		if (CurrentThemeId != ThemeId)
 		{
-			// Unload the current theme
-			if (CurrentThemeId.IsValid())
-			{
-				CurrentTheme = &GetCurrentTheme_Mutable();
-				// Unload existing schemes
-				CurrentTheme->LoadedDefaultColorSchemes.Empty();
-			}
-
 			// Load the new theme
-			if (FColorizedFolderTheme* Theme = LoadedThemes.FindByKey(ThemeId))
+			if (ThemeIdToIndex.Contains(ThemeId))
 			{
 				CurrentThemeId = ThemeId;
-				SaveConfig();
+				RequestSaveConfig();
 			}
 		}
 
-		CurrentTheme = &GetCurrentTheme_Mutable();
+		// The schemes have been parsed together with the theme already, only themes without a file have to be read here
+		FColorizedFolderTheme* CurrentTheme = &GetCurrentTheme_Mutable();
 		LoadThemeFolderSchemes(*CurrentTheme);
 
-		// Apply the new colors
-		if (CurrentTheme->LoadedDefaultColorSchemes.Num() > 0)
+		// Apply the new colors, publishing the theme's snapshot is all that readers see
+		SchemeSnapshot = GetCompiledTheme(*CurrentTheme);
+
+		// The theme editor works on its own copy of the schemes
+		const int32 NumSchemes = FMath::Min(SchemeSnapshot->Schemes.Num(), NUM_FOLDER_SCHEMES);
+		for (int32 SchemeIndex = 0; SchemeIndex < NumSchemes; ++SchemeIndex)
 		{
-			FMemory::Memcpy(ActiveSchemes.Schemes, CurrentTheme->LoadedDefaultColorSchemes.GetData(), sizeof(FColorizedFolderColorScheme) * CurrentTheme->LoadedDefaultColorSchemes.Num());
+			ActiveSchemes.Schemes[SchemeIndex] = SchemeSnapshot->Schemes[SchemeIndex];
 		}
+
+		TRACE_BOOKMARK(TEXT("ColorizedFolders: Applied theme %s"), *CurrentTheme->DisplayName.ToString());
 	}
 	OnThemeChanged().Broadcast(CurrentThemeId);
 }
@@ -157,33 +182,15 @@ void UColorizedFoldersManager::ApplyDefaultTheme()
 
 bool UColorizedFoldersManager::IsEngineTheme() const
 {
-	// users cannot edit/delete engine-specific themes: 
-	const FString EnginePath = GetEngineThemeDir() / GetCurrentTheme().DisplayName.ToString() + TEXT(".json");
-
-	IPlatformFile& FileManager = FPlatformFileManager::Get().GetPlatformFile();
-	if (GetCurrentTheme() == DefaultTheme)
-	{
-		return true;
-	}
-	if (FileManager.FileExists(*EnginePath))
-	{
-		return true;
-	}
-	return false;
+	// users cannot edit/delete engine-specific themes
+	const FColorizedFolderTheme& CurrentTheme = GetCurrentTheme();
+	return CurrentTheme == DefaultTheme || CurrentTheme.HasOrigin(EColorizedFolderThemeOrigin::Default) || CurrentTheme.HasOrigin(EColorizedFolderThemeOrigin::Engine);
 }
 
 bool UColorizedFoldersManager::IsProjectTheme() const
 {
-	// users cannot edit/delete project-specific themes: 
-	const FString ProjectPath = GetProjectThemeDir() / GetCurrentTheme().DisplayName.ToString() + TEXT(".json");
-
-	IPlatformFile& FileManager = FPlatformFileManager::Get().GetPlatformFile(); 
-
-	if (FileManager.FileExists(*ProjectPath))
-	{
-		return true; 
-	}
-	return false; 
+	// users cannot edit/delete project-specific themes
+	return GetCurrentTheme().HasOrigin(EColorizedFolderThemeOrigin::Project);
 }
 
 void UColorizedFoldersManager::RemoveTheme(FGuid ThemeId)
@@ -192,6 +199,7 @@ void UColorizedFoldersManager::RemoveTheme(FGuid ThemeId)
 	if (CurrentThemeId != ThemeId)
 	{
 		LoadedThemes.RemoveAll([&ThemeId](const FColorizedFolderTheme& TestTheme) { return TestTheme.Id == ThemeId; });
+		RebuildThemeLookups();
 	}
 }
 
@@ -205,7 +213,7 @@ FGuid UColorizedFoldersManager::DuplicateActiveTheme()
 	NewTheme.DisplayName = FText::Format(LOCTEXT("ThemeDuplicateCopyText", "{0} - Copy"), CurrentTheme.DisplayName);
 	NewTheme.LoadedDefaultColorSchemes = MakeArrayView<FColorizedFolderColorScheme>(ActiveSchemes.Schemes, NUM_FOLDER_SCHEMES);
 
-	LoadedThemes.Add(MoveTemp(NewTheme));
+	AddTheme(MoveTemp(NewTheme));
 
 	return NewThemeGuid;
 }
@@ -213,6 +221,7 @@ FGuid UColorizedFoldersManager::DuplicateActiveTheme()
 void UColorizedFoldersManager::SetCurrentThemeDisplayName(FText NewDisplayName)
 {
 	GetCurrentTheme_Mutable().DisplayName = NewDisplayName;
+	RebuildThemeLookups();
 }
 
 void UColorizedFoldersManager::ValidateActiveTheme()
@@ -247,9 +256,14 @@ FString UColorizedFoldersManager::GetPluginThemeDir()
 
 bool UColorizedFoldersManager::DoesThemeExist(const FGuid& ThemeId) const
 {
-	for (const auto& Theme : LoadedThemes)
+	return ThemeIdToIndex.Contains(ThemeId);
+}
+
+bool UColorizedFoldersManager::DoesThemeNameExist(const FString& DisplayName) const
+{
+	for (auto It = DisplayNameToIndex.CreateConstKeyIterator(DisplayName); It; ++It)
 	{
-		if (Theme.Id == ThemeId)
+		if (LoadedThemes[It.Value()].DisplayName.ToString().Equals(DisplayName, ESearchCase::CaseSensitive))
 		{
 			return true;
 		}
@@ -258,39 +272,104 @@ bool UColorizedFoldersManager::DoesThemeExist(const FGuid& ThemeId) const
 	return false;
 }
 
-void UColorizedFoldersManager::LoadThemesFromDirectory(const FString& Directory)
+void UColorizedFoldersManager::AddTheme(FColorizedFolderTheme&& Theme)
 {
+	const int32 ThemeIndex = LoadedThemes.Add(MoveTemp(Theme));
+	ThemeIdToIndex.Add(LoadedThemes[ThemeIndex].Id, ThemeIndex);
+	DisplayNameToIndex.Add(LoadedThemes[ThemeIndex].DisplayName.ToString(), ThemeIndex);
+}
+
+void UColorizedFoldersManager::RebuildThemeLookups()
+{
+	ThemeIdToIndex.Reset();
+	DisplayNameToIndex.Reset();
+	CurrentThemeIndex = INDEX_NONE;
+
+	for (int32 ThemeIndex = 0; ThemeIndex < LoadedThemes.Num(); ++ThemeIndex)
+	{
+		ThemeIdToIndex.Add(LoadedThemes[ThemeIndex].Id, ThemeIndex);
+		DisplayNameToIndex.Add(LoadedThemes[ThemeIndex].DisplayName.ToString(), ThemeIndex);
+	}
+}
+
+void UColorizedFoldersManager::LoadThemesFromDirectory(const FString& Directory, EColorizedFolderThemeOrigin Origin)
+{
+	COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::LoadThemesFromDirectory");
+
 	TArray<FString> ThemeFiles;
 	IFileManager::Get().FindFiles(ThemeFiles, *Directory, TEXT(".json"));
 
 	for (const FString& ThemeFile : ThemeFiles)
 	{
-		bool bValidFile = false;
-		FString ThemeData;
 		FString ThemeFilename = Directory / ThemeFile;
-		if (FFileHelper::LoadFileToString(ThemeData, *ThemeFilename))
+		FColorizedFolderTheme Theme;
+		UE::ColorizedFolders::FColorizedFoldersSchemeSnapshotPtr Compiled;
+		if (ReadThemeFile(ThemeFilename, Theme, Compiled))
 		{
-			FColorizedFolderTheme Theme;
-			if (ReadTheme(ThemeData, Theme))
+			INC_DWORD_STAT(STAT_ColorizedFolders_ThemesLoaded);
+
+			if (Compiled.IsValid())
 			{
-				if (FColorizedFolderTheme* ExistingTheme = LoadedThemes.FindByKey(Theme.Id))
-				{
-					// Just update the existing theme.
-					// Themes with the same id can override an existing one.
-					// This behavior mimics config file hierarchies
-					ExistingTheme->Filename = MoveTemp(ThemeFilename);
-				}
-				else
-				{
-					// Theme not found, add a new one
-					Theme.Filename = MoveTemp(ThemeFilename);
-					LoadedThemes.Add(MoveTemp(Theme));
-				}
+				CompiledThemes.Add(Theme.Id, Compiled.ToSharedRef());
+			}
+			else
+			{
+				CompiledThemes.Remove(Theme.Id);
+			}
+
+			if (FColorizedFolderTheme* ExistingTheme = FindTheme_Mutable(Theme.Id))
+			{
+				// Just update the existing theme.
+				// Themes with the same id can override an existing one.
+				// This behavior mimics config file hierarchies
+				ExistingTheme->Filename = MoveTemp(ThemeFilename);
+				ExistingTheme->OverriddenOrigins.Add(ExistingTheme->Origin);
+				ExistingTheme->Origin = Origin;
+				ExistingTheme->LoadedDefaultColorSchemes = MoveTemp(Theme.LoadedDefaultColorSchemes);
+			}
+			else
+			{
+				// Theme not found, add a new one
+				Theme.Filename = MoveTemp(ThemeFilename);
+				Theme.Origin = Origin;
+				AddTheme(MoveTemp(Theme));
 			}
 		}
 	}
 }
 
+bool UColorizedFoldersManager::ReadThemeFile(const FString& ThemeFilename, FColorizedFolderTheme& OutTheme, UE::ColorizedFolders::FColorizedFoldersSchemeSnapshotPtr& OutCompiled)
+{
+	COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::ReadThemeFile");
+
+	using namespace UE::ColorizedFolders;
+
+	// Prefer the compiled theme, as long as it's up to date with the JSON file
+	OutTheme.LoadedDefaultColorSchemes = MakeArrayView<const FColorizedFolderColorScheme>(DefaultColorSchemes, NUM_FOLDER_SCHEMES);
+	FColorizedFoldersSchemeMatcher Matcher;
+	const FDateTime SourceTimestamp = IFileManager::Get().GetTimeStamp(*ThemeFilename);
+	const FString CachedFilename = FColorizedFoldersCompiledTheme::GetCachedCompiledFilename(ThemeFilename);
+	if (FColorizedFoldersCompiledTheme::Read(FColorizedFoldersCompiledTheme::GetCompiledFilename(ThemeFilename), SourceTimestamp, OutTheme, Matcher) ||
+		FColorizedFoldersCompiledTheme::Read(CachedFilename, SourceTimestamp, OutTheme, Matcher))
+	{
+		OutCompiled = MakeShared<const FColorizedFoldersSchemeSnapshot, ESPMode::ThreadSafe>(OutTheme.LoadedDefaultColorSchemes, MoveTemp(Matcher));
+		return true;
+	}
+
+	OutCompiled.Reset();
+	FString ThemeData;
+	if (!FFileHelper::LoadFileToString(ThemeData, *ThemeFilename) || !ReadTheme(ThemeData, OutTheme))
+	{
+		return false;
+	}
+
+	// Compile the theme for the next time it's loaded, themes that ship as JSON only would never use the compiled form otherwise.
+	// The theme directory itself may be read-only or under source control, so the compiled file goes to the intermediate dir.
+	COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::WriteCompiledTheme");
+	FColorizedFoldersCompiledTheme::Write(CachedFilename, OutTheme, OutTheme.LoadedDefaultColorSchemes, SourceTimestamp);
+	return true;
+}
+
 bool UColorizedFoldersManager::ReadTheme(const FString& ThemeData, FColorizedFolderTheme& OutTheme)
 {
 	TSharedRef<TJsonReader<>> ReaderRef = TJsonReaderFactory<>::Create(ThemeData);
@@ -319,11 +398,13 @@ bool UColorizedFoldersManager::ReadTheme(const FString& ThemeData, FColorizedFol
 
 		OutTheme.DisplayName = FText::FromString(MoveTemp(DisplayString));
 
-		// Just check that the theme has schemes. We won't load them unless the theme is used
 		if (!ObjectPtr->HasField(TEXT("Schemes")))
 		{
 			return false;
 		}
+
+		// Keep the schemes right away, so the file never has to be read again
+		ReadThemeSchemes(*ObjectPtr, OutTheme);
 	}
 	else
 	{
@@ -338,71 +419,257 @@ void UColorizedFoldersManager::EnsureValidCurrentTheme()
 	DefaultTheme.DisplayName = LOCTEXT("DefaultFolderColorTheme", "No Theme");
 	DefaultTheme.Id = FGuid(0x13438026, 0x5FBB4A9C, 0xA00A1DC9, 0x770217B8);
 	DefaultTheme.Filename = IPluginManager::Get().FindPlugin(TEXT("ColorizedFolders"))->GetBaseDir() / TEXT("Resources/Themes/NoTheme.json");
+	DefaultTheme.Origin = EColorizedFolderThemeOrigin::Default;
 
-	int32 ThemeIndex = LoadedThemes.AddUnique(DefaultTheme);
+	if (!DoesThemeExist(DefaultTheme.Id))
+	{
+		AddTheme(CopyTemp(DefaultTheme));
+	}
 
-	if (!CurrentThemeId.IsValid() || !LoadedThemes.Contains(CurrentThemeId))
+	if (!CurrentThemeId.IsValid() || !DoesThemeExist(CurrentThemeId))
 	{
 		CurrentThemeId = DefaultTheme.Id;
 	}
 }
 
+void UColorizedFoldersManager::ReadThemeSchemes(const FJsonObject& ThemeObject, FColorizedFolderTheme& OutTheme) const
+{
+	OutTheme.LoadedDefaultColorSchemes = MakeArrayView<const FColorizedFolderColorScheme>(DefaultColorSchemes, NUM_FOLDER_SCHEMES);
+
+	const TSharedPtr<FJsonObject>* SchemesObject = nullptr;
+	if (!ThemeObject.TryGetObjectField(TEXT("Schemes"), SchemesObject))
+	{
+		return;
+	}
+
+	for (int32 SchemeIndex = 0; SchemeIndex < NUM_FOLDER_SCHEMES; ++SchemeIndex)
+	{
+		const TSharedPtr<FJsonObject>* SchemeObject = nullptr;
+		if ((*SchemesObject)->TryGetObjectField(FString::FromInt(SchemeIndex), SchemeObject))
+		{
+			FString ColorString;
+			if ((*SchemeObject)->TryGetStringField(TEXT("SchemeColor"), ColorString))
+			{
+				OutTheme.LoadedDefaultColorSchemes[SchemeIndex].SchemeColor.InitFromString(ColorString);
+			}
+
+			// Themes written before inheritance existed just don't have these fields
+			FColorizedFolderColorScheme& Scheme = OutTheme.LoadedDefaultColorSchemes[SchemeIndex];
+			(*SchemeObject)->TryGetBoolField(TEXT("InheritToChildren"), Scheme.bInheritToChildren);
+			(*SchemeObject)->TryGetNumberField(TEXT("InheritDepth"), Scheme.InheritDepth);
+			(*SchemeObject)->TryGetNumberField(TEXT("InheritDesaturation"), Scheme.InheritDesaturation);
+
+			TArray<FString> FolderNames;
+			if ((*SchemeObject)->TryGetStringArrayField(TEXT("FolderNames"), FolderNames))
+			{
+				OutTheme.LoadedDefaultColorSchemes[SchemeIndex].SaveArrayToFolders(FolderNames);
+			}
+
+			TArray<FString> PathNames;
+			if ((*SchemeObject)->TryGetStringArrayField(TEXT("ExplicitPaths"), PathNames))
+			{
+				OutTheme.LoadedDefaultColorSchemes[SchemeIndex].SaveArrayToPaths(PathNames);
+			}
+		}
+	}
+}
+
 void UColorizedFoldersManager::LoadThemeFolderSchemes(FColorizedFolderTheme& Theme)
 {
-	FString ThemeData;
+	if (!Theme.LoadedDefaultColorSchemes.IsEmpty())
+	{
+		return;
+	}
 
-	if (Theme.LoadedDefaultColorSchemes.IsEmpty())
+	// Only themes that weren't discovered by LoadThemes(), like the default theme, end up here
+	FColorizedFolderTheme ReadFromFile;
+	UE::ColorizedFolders::FColorizedFoldersSchemeSnapshotPtr Compiled;
+	if (ReadThemeFile(Theme.Filename, ReadFromFile, Compiled))
 	{
-		Theme.LoadedDefaultColorSchemes = MakeArrayView<FColorizedFolderColorScheme>(DefaultColorSchemes, NUM_FOLDER_SCHEMES);
+		Theme.LoadedDefaultColorSchemes = MoveTemp(ReadFromFile.LoadedDefaultColorSchemes);
+		if (Compiled.IsValid())
+		{
+			CompiledThemes.Add(Theme.Id, Compiled.ToSharedRef());
+		}
 	}
-	
-	if (FFileHelper::LoadFileToString(ThemeData, *Theme.Filename))
+	else
+	{
+		Theme.LoadedDefaultColorSchemes = MakeArrayView<const FColorizedFolderColorScheme>(DefaultColorSchemes, NUM_FOLDER_SCHEMES);
+	}
+}
+
+UE::ColorizedFolders::FColorizedFoldersSchemeSnapshotRef UColorizedFoldersManager::GetCompiledTheme(const FColorizedFolderTheme& Theme)
+{
+	using namespace UE::ColorizedFolders;
+
+	if (const FColorizedFoldersSchemeSnapshotRef* Existing = CompiledThemes.Find(Theme.Id))
 	{
-		TSharedRef<TJsonReader<>> ReaderRef = TJsonReaderFactory<>::Create(ThemeData);
-		TJsonReader<>& Reader = ReaderRef.Get();
+		return *Existing;
+	}
+
+	COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::CompileTheme");
+	FColorizedFoldersSchemeSnapshotRef Compiled = MakeShared<const FColorizedFoldersSchemeSnapshot, ESPMode::ThreadSafe>(Theme.LoadedDefaultColorSchemes);
+	CompiledThemes.Add(Theme.Id, Compiled);
+	return Compiled;
+}
 
-		TSharedPtr<FJsonObject> ObjectPtr;
-		if (FJsonSerializer::Deserialize(Reader, ObjectPtr) && ObjectPtr.IsValid())
+void UColorizedFoldersManager::WatchThemeDirectories()
+{
+	StopWatchingThemeDirectories();
+
+	FDirectoryWatcherModule& DirectoryWatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule.Get();
+	if (DirectoryWatcher == nullptr)
+	{
+		return;
+	}
+
+	const TPair<FString, EColorizedFolderThemeOrigin> ThemeDirectories[] =
+	{
+		{ GetPluginThemeDir(), EColorizedFolderThemeOrigin::Plugin },
+		{ GetEngineThemeDir(), EColorizedFolderThemeOrigin::Engine },
+		{ GetProjectThemeDir(), EColorizedFolderThemeOrigin::Project },
+		{ GetUserThemeDir(), EColorizedFolderThemeOrigin::User },
+	};
+
+	for (const TPair<FString, EColorizedFolderThemeOrigin>& ThemeDirectory : ThemeDirectories)
+	{
+		if (!IFileManager::Get().DirectoryExists(*ThemeDirectory.Key))
 		{
-			// Check that the theme has schemes. We won't load them unless the theme is used
-			const TSharedPtr<FJsonObject>* SchemesObject = nullptr;
-			if (ObjectPtr->TryGetObjectField(TEXT("Schemes"), SchemesObject))
+			continue;
+		}
+
+		FDelegateHandle Handle;
+		if (DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(ThemeDirectory.Key,
+			IDirectoryWatcher::FDirectoryChanged::CreateUObject(this, &UColorizedFoldersManager::OnThemeDirectoryChanged, ThemeDirectory.Value), Handle))
+		{
+			ThemeDirectoryWatchers.Emplace(ThemeDirectory.Key, Handle);
+		}
+	}
+}
+
+void UColorizedFoldersManager::StopWatchingThemeDirectories()
+{
+	if (FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+	{
+		if (IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule->Get())
+		{
+			for (const TPair<FString, FDelegateHandle>& Watcher : ThemeDirectoryWatchers)
 			{
-				for (int32 SchemeIndex = 0; SchemeIndex < NUM_FOLDER_SCHEMES; ++SchemeIndex)
-				{
-					const TSharedPtr<FJsonObject>* SchemeObject = nullptr;
-					if ((*SchemesObject)->TryGetObjectField(FString::FromInt(SchemeIndex), SchemeObject))
-					{
-						FString ColorString;
-						if ((*SchemeObject)->TryGetStringField(TEXT("SchemeColor"), ColorString))
-						{
-							Theme.LoadedDefaultColorSchemes[SchemeIndex].SchemeColor.InitFromString(ColorString);	
-						}
-						
-						TArray<FString> FolderNames;
-						if ((*SchemeObject)->TryGetStringArrayField(TEXT("FolderNames"), FolderNames))
-						{
-							Theme.LoadedDefaultColorSchemes[SchemeIndex].SaveArrayToFolders(FolderNames);	
-						}
-						
-						TArray<FString> PathNames;
-						if ((*SchemeObject)->TryGetStringArrayField(TEXT("ExplicitPaths"), PathNames))
-						{
-							Theme.LoadedDefaultColorSchemes[SchemeIndex].SaveArrayToPaths(PathNames);	
-						}
-					}
-					SchemeObject = nullptr;
-				}
+				DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(Watcher.Key, Watcher.Value);
 			}
-			SchemesObject = nullptr;
 		}
 	}
+
+	ThemeDirectoryWatchers.Empty();
+}
+
+void UColorizedFoldersManager::RequestSaveConfig()
+{
+	if (SaveConfigTickerHandle.IsValid())
+	{
+		return;
+	}
+
+	SaveConfigTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float)
+	{
+		SaveConfigTickerHandle.Reset();
+
+		COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::SaveConfig");
+		SaveConfig();
+		return false;
+	}));
+}
+
+void UColorizedFoldersManager::FlushPendingSaveConfig()
+{
+	if (!SaveConfigTickerHandle.IsValid())
+	{
+		return;
+	}
+
+	FTSTicker::GetCoreTicker().RemoveTicker(SaveConfigTickerHandle);
+	SaveConfigTickerHandle.Reset();
+
+	COLORIZEDFOLDERS_TRACE_SCOPE("ColorizedFolders::SaveConfig");
+	SaveConfig();
+}
+
+void UColorizedFoldersManager::OnThemeDirectoryChanged(const TArray<FFileChangeData>& FileChanges, EColorizedFolderThemeOrigin Origin)
+{
+	bool bCurrentThemeChanged = false;
+	for (const FFileChangeData& FileChange : FileChanges)
+	{
+		if (!FPaths::GetExtension(FileChange.Filename).Equals(TEXT("json"), ESearchCase::IgnoreCase))
+		{
+			continue;
+		}
+
+		FColorizedFolderTheme* ChangedTheme = LoadedThemes.FindByPredicate([&FileChange](const FColorizedFolderTheme& Theme)
+		{
+			return FPaths::IsSamePath(Theme.Filename, FileChange.Filename);
+		});
+
+		if (FileChange.Action == FFileChangeData::FCA_Removed)
+		{
+			if (ChangedTheme)
+			{
+				CompiledThemes.Remove(ChangedTheme->Id);
+			}
+			continue;
+		}
+
+		FColorizedFolderTheme Theme;
+		UE::ColorizedFolders::FColorizedFoldersSchemeSnapshotPtr Compiled;
+		if (!ReadThemeFile(FileChange.Filename, Theme, Compiled))
+		{
+			continue;
+		}
+
+		if (ChangedTheme && ChangedTheme->Id == Theme.Id)
+		{
+			bCurrentThemeChanged |= Theme.Id == CurrentThemeId;
+			ChangedTheme->DisplayName = MoveTemp(Theme.DisplayName);
+			ChangedTheme->LoadedDefaultColorSchemes = MoveTemp(Theme.LoadedDefaultColorSchemes);
+			RebuildThemeLookups();
+		}
+		else if (!DoesThemeExist(Theme.Id))
+		{
+			// A new theme has been dropped into one of the theme directories
+			Theme.Filename = FileChange.Filename;
+			Theme.Origin = Origin;
+			AddTheme(CopyTemp(Theme));
+		}
+		else
+		{
+			continue;
+		}
+
+		if (Compiled.IsValid())
+		{
+			CompiledThemes.Add(Theme.Id, Compiled.ToSharedRef());
+		}
+		else
+		{
+			CompiledThemes.Remove(Theme.Id);
+		}
+	}
+
+	// Publish the edited schemes of the active theme, so they take effect without switching themes
+	if (bCurrentThemeChanged)
+	{
+		ApplyTheme(CurrentThemeId);
+	}
 }
 
 #if WITH_EDITOR
 void UColorizedFoldersManager::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
 	UObject::PostEditChangeProperty(PropertyChangedEvent);
+
+	// The schemes may have been edited in the theme editor, which makes them differ from the compiled theme.
+	// Scans that are still running keep the snapshot they started with.
+	SchemeSnapshot = MakeShared<const UE::ColorizedFolders::FColorizedFoldersSchemeSnapshot, ESPMode::ThreadSafe>(MakeArrayView(ActiveSchemes.Schemes));
 }
 #endif
 #endif
@@ -4,10 +4,15 @@
 
 #include "CoreMinimal.h"
 #include "ColorizedFoldersTheme.h"
+#include "ColorizedFoldersSchemeSnapshot.h"
+#include "Containers/Ticker.h"
 #include "UObject/Object.h"
 
 #include "ColorizedFoldersManager.generated.h"
 
+class FJsonObject;
+struct FFileChangeData;
+
 UCLASS(Config=EditorSettings, MinimalAPI)
 class UColorizedFoldersManager : public UObject
 {
@@ -35,7 +40,27 @@ public:
 
 	static const FColorizedFolderColorScheme& GetScheme(int32 Index)
 	{
-		return Get().ActiveSchemes.Schemes[Index];
+		return Get().SchemeSnapshot->Schemes[Index];
+	}
+
+	static TConstArrayView<FColorizedFolderColorScheme> GetSchemes()
+	{
+		return Get().SchemeSnapshot->Schemes;
+	}
+
+	/** Returns the compiled folder name lookup of the active schemes. */
+	static const UE::ColorizedFolders::FColorizedFoldersSchemeMatcher& GetSchemeMatcher()
+	{
+		return Get().SchemeSnapshot->Matcher;
+	}
+
+	/**
+	 * Returns the published snapshot of the active schemes. Only call this on the game thread, the returned reference
+	 * can then be handed to other threads and stays valid and unchanged however often the schemes change afterwards.
+	 */
+	static UE::ColorizedFolders::FColorizedFoldersSchemeSnapshotRef GetSchemeSnapshot()
+	{
+		return Get().SchemeSnapshot;
 	}
 
 	void SetCurrentThemeId_Direct(FGuid NewThemeId)
@@ -51,7 +76,6 @@ public:
 	FOnThemeChanged ThemeChangedEvent;
 
 	FColorizedFolderTheme DefaultTheme;
-	TArray<FColorizedFolderTheme> LoadedThemes;
 	FColorizedFolderColorScheme DefaultColorSchemes[NUM_FOLDER_SCHEMES];
 
 
@@ -79,10 +103,10 @@ public:
 	/** Applies the default theme as the active theme */
 	void ApplyDefaultTheme();
 
-	/** Returns true if the active theme is an engine-specific theme */
+	/** Returns true if the active theme is an engine-specific theme. Only reads the origin recorded at load time. */
 	bool IsEngineTheme() const;
 
-	/** Returns true if the active theme is a project-specific theme */
+	/** Returns true if the active theme is a project-specific theme. Only reads the origin recorded at load time. */
 	bool IsProjectTheme() const;
 
 	/** Removes a theme from the list of known themes */
@@ -97,9 +121,19 @@ public:
 	/** Gets the current theme */
 	const FColorizedFolderTheme& GetCurrentTheme() const
 	{
-		return *LoadedThemes.FindByKey(CurrentThemeId);
+		return LoadedThemes[GetCurrentThemeIndex()];
 	}
 
+	/** Returns the theme with the given id, or nullptr */
+	const FColorizedFolderTheme* FindTheme(const FGuid& ThemeId) const
+	{
+		const int32* ThemeIndex = ThemeIdToIndex.Find(ThemeId);
+		return ThemeIndex ? &LoadedThemes[*ThemeIndex] : nullptr;
+	}
+
+	/** Returns true if any theme uses the display name. Case-sensitive. */
+	bool DoesThemeNameExist(const FString& DisplayName) const;
+
 	/** Gets all known themes */
 	const TArray<FColorizedFolderTheme>& GetThemes() const
 	{
@@ -124,17 +158,82 @@ public:
 	/** Returns true if the theme ID already exists in the theme dropdown */
 	bool DoesThemeExist(const FGuid& ThemeId) const;
 
+	/** Stops listening for changes to the theme files. */
+	void StopWatchingThemeDirectories();
+
+	/** Saves the current theme id right away if applying a theme has scheduled a save. */
+	void FlushPendingSaveConfig();
+
 private:
 	FColorizedFolderTheme& GetCurrentTheme_Mutable()
 	{
-		return *LoadedThemes.FindByKey(CurrentThemeId);
+		return LoadedThemes[GetCurrentThemeIndex()];
+	}
+
+	FColorizedFolderTheme* FindTheme_Mutable(const FGuid& ThemeId)
+	{
+		const int32* ThemeIndex = ThemeIdToIndex.Find(ThemeId);
+		return ThemeIndex ? &LoadedThemes[*ThemeIndex] : nullptr;
 	}
 
-	void LoadThemesFromDirectory(const FString& Directory);
+	/** Returns the index of the current theme, resolving it again only if the current theme id has changed. */
+	int32 GetCurrentThemeIndex() const
+	{
+		// The id may also be changed directly, e.g. when the config is reloaded
+		if (!LoadedThemes.IsValidIndex(CurrentThemeIndex) || LoadedThemes[CurrentThemeIndex].Id != CurrentThemeId)
+		{
+			const int32* ThemeIndex = ThemeIdToIndex.Find(CurrentThemeId);
+			CurrentThemeIndex = ThemeIndex ? *ThemeIndex : INDEX_NONE;
+		}
+		return CurrentThemeIndex;
+	}
+
+	/** Adds a theme to the list of known themes and its lookups. */
+	void AddTheme(FColorizedFolderTheme&& Theme);
+
+	/** Rebuilds the lookups after themes have been removed or renamed. */
+	void RebuildThemeLookups();
+
+	/** All known themes, in the order they are shown in the theme picker. */
+	TArray<FColorizedFolderTheme> LoadedThemes;
+
+	/** Index into LoadedThemes by theme id. */
+	TMap<FGuid, int32> ThemeIdToIndex;
+
+	/** Indices into LoadedThemes by display name. FString keys are hashed case-insensitively, but several themes can share a name. */
+	TMultiMap<FString, int32> DisplayNameToIndex;
+
+	/** Cached index of the current theme in LoadedThemes. */
+	mutable int32 CurrentThemeIndex = INDEX_NONE;
+
+	void LoadThemesFromDirectory(const FString& Directory, EColorizedFolderThemeOrigin Origin);
 	bool ReadTheme(const FString& ThemeData, FColorizedFolderTheme& OutTheme);
+
+	/** Reads a theme from its compiled file if that is up to date, and from the JSON file otherwise. OutCompiled is only set for compiled files. */
+	bool ReadThemeFile(const FString& ThemeFilename, FColorizedFolderTheme& OutTheme, UE::ColorizedFolders::FColorizedFoldersSchemeSnapshotPtr& OutCompiled);
+	void ReadThemeSchemes(const FJsonObject& ThemeObject, FColorizedFolderTheme& OutTheme) const;
 	void EnsureValidCurrentTheme();
 	void LoadThemeFolderSchemes(FColorizedFolderTheme& Theme);
 
+	/** Returns the snapshot of a theme's schemes, compiling them only the first time the theme is applied. */
+	UE::ColorizedFolders::FColorizedFoldersSchemeSnapshotRef GetCompiledTheme(const FColorizedFolderTheme& Theme);
+
+	/** Starts listening for changes to the theme files, so the cached themes can be updated. Changes to the active theme are applied right away. */
+	void WatchThemeDirectories();
+	void OnThemeDirectoryChanged(const TArray<FFileChangeData>& FileChanges, EColorizedFolderThemeOrigin Origin);
+
+	/** Saves the current theme id on the next tick, so switching through several themes writes the config only once. */
+	void RequestSaveConfig();
+
+	/** Snapshots of every theme that has been applied, until its file changes. Applying a theme again just publishes its snapshot. */
+	TMap<FGuid, UE::ColorizedFolders::FColorizedFoldersSchemeSnapshotRef> CompiledThemes;
+
+	/** Theme directories we are watching, along with the handle of our callback. */
+	TArray<TPair<FString, FDelegateHandle>> ThemeDirectoryWatchers;
+
+	/** Pending save of the current theme id, see RequestSaveConfig(). */
+	FTSTicker::FDelegateHandle SaveConfigTickerHandle;
+
 protected:
 	//~ Begin UObject Interface
 #if WITH_EDITOR
@@ -147,6 +246,10 @@ private:
 	UPROPERTY(EditAnywhere, Config, Category=ContentBrowser)
 	FGuid CurrentThemeId;
 
+	/** Editable copy of the active schemes for the theme editor, published as a new snapshot whenever it's edited. */
 	UPROPERTY(EditAnywhere, Transient, Category=ContentBrowser)
 	FColorizedFolderColorSchemeList ActiveSchemes;
+
+	/** The active schemes everything else reads. Replaced as a whole, never modified. */
+	UE::ColorizedFolders::FColorizedFoldersSchemeSnapshotRef SchemeSnapshot = MakeShared<const UE::ColorizedFolders::FColorizedFoldersSchemeSnapshot, ESPMode::ThreadSafe>(MakeArrayView(ActiveSchemes.Schemes));
 };
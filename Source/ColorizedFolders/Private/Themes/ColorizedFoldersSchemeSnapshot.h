@@ -0,0 +1,49 @@
+﻿// Copyright © 2025 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ColorizedFoldersTheme.h"
+#include "Folders/ColorizedFoldersSchemeMatcher.h"
+
+namespace UE::ColorizedFolders
+{
+	/**
+	 * The schemes of a theme along with their compiled lookup, as they were when the snapshot was published.
+	 * Snapshots are never modified once they are shared, so background scans and the UI can keep reading
+	 * their own reference without any locking, while the manager publishes a new snapshot in the meantime.
+	 */
+	struct FColorizedFoldersSchemeSnapshot
+	{
+		/** Copies the schemes and compiles them. */
+		explicit FColorizedFoldersSchemeSnapshot(TConstArrayView<FColorizedFolderColorScheme> InSchemes)
+			: Schemes(InSchemes)
+		{
+			Matcher.Compile(Schemes);
+		}
+
+		/** Copies the schemes, along with a lookup that has been compiled already. */
+		FColorizedFoldersSchemeSnapshot(TConstArrayView<FColorizedFolderColorScheme> InSchemes, FColorizedFoldersSchemeMatcher&& InMatcher)
+			: Schemes(InSchemes)
+			, Matcher(MoveTemp(InMatcher))
+		{
+		}
+
+		/** Returns a hash of all schemes, to tell whether folders resolved against another snapshot are still valid. */
+		uint32 GetSchemesHash() const
+		{
+			uint32 Hash = 0;
+			for (const FColorizedFolderColorScheme& Scheme : Schemes)
+			{
+				Hash = HashCombineFast(Hash, GetTypeHash(Scheme));
+			}
+			return Hash;
+		}
+
+		TArray<FColorizedFolderColorScheme> Schemes;
+		FColorizedFoldersSchemeMatcher Matcher;
+	};
+
+	using FColorizedFoldersSchemeSnapshotRef = TSharedRef<const FColorizedFoldersSchemeSnapshot, ESPMode::ThreadSafe>;
+	using FColorizedFoldersSchemeSnapshotPtr = TSharedPtr<const FColorizedFoldersSchemeSnapshot, ESPMode::ThreadSafe>;
+}
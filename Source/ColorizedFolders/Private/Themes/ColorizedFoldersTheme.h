@@ -17,6 +17,8 @@ struct FColorizedFolderColorScheme
 	/**
 	 * A list of folder names that should use this color scheme.
 	 * Separate multiple folder names with a comma.
+	 * Names may use wildcards, e.g. "UI*", "*_Data" or "Abilit[iy]*". Exact names take precedence over wildcards.
+	 * If multiple schemes list the same name, the scheme with the higher number wins.
 	 */
 	UPROPERTY(EditDefaultsOnly, Category = Scheme)
 	FString FolderNames;
@@ -24,6 +26,8 @@ struct FColorizedFolderColorScheme
 	/**
 	 * A list of explicit paths that should use this color scheme.
 	 * Separate multiple paths with a comma.
+	 * Path segments may use wildcards: "*" matches any single folder, and "**" matches any number of folders.
+	 * Explicit paths take precedence over folder names of any scheme, and paths without wildcards over paths with wildcards.
 	 */
 	UPROPERTY(EditDefaultsOnly, Category = Scheme)
 	FString ExplicitPaths;
@@ -32,6 +36,35 @@ struct FColorizedFolderColorScheme
 	UPROPERTY(EditDefaultsOnly, Category = Scheme)
 	FLinearColor SchemeColor = FLinearColor();
 
+	/**
+	 * Whether the subfolders of matching folders get this color as well.
+	 * Subfolders that match a scheme themselves use their own scheme instead, which is then passed on to their subfolders.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = Scheme)
+	bool bInheritToChildren = false;
+
+	/** How many levels of subfolders inherit the color. 0 colors the whole subtree. */
+	UPROPERTY(EditDefaultsOnly, Category = Scheme, meta = (ClampMin = 0, EditCondition = bInheritToChildren))
+	int32 InheritDepth = 0;
+
+	/** How much the inherited color is desaturated per level, so deeper subfolders are tinted more subtly. */
+	UPROPERTY(EditDefaultsOnly, Category = Scheme, meta = (ClampMin = 0, ClampMax = 1, EditCondition = bInheritToChildren))
+	float InheritDesaturation = 0.f;
+
+	/** Returns true if a subfolder the given number of levels below a matching folder inherits this scheme. */
+	bool InheritsTo(int32 Distance) const
+	{
+		return bInheritToChildren && (InheritDepth <= 0 || Distance <= InheritDepth);
+	}
+
+	/** Returns the color of a subfolder the given number of levels below a matching folder. */
+	FLinearColor GetInheritedColor(int32 Distance) const
+	{
+		FLinearColor InheritedColor = SchemeColor.Desaturate(1.f - FMath::Pow(1.f - InheritDesaturation, static_cast<float>(Distance)));
+		InheritedColor.A = SchemeColor.A;
+		return InheritedColor;
+	}
+
 	/** Resolves the folder names into a list of unique folder names. */
 	TArray<FString> ResolveFolderNames() const;
 
@@ -48,7 +81,19 @@ struct FColorizedFolderColorScheme
 	{
 		return FolderNames == Other.FolderNames &&
 			ExplicitPaths == Other.ExplicitPaths &&
-			SchemeColor == Other.SchemeColor;
+			SchemeColor == Other.SchemeColor &&
+			bInheritToChildren == Other.bInheritToChildren &&
+			InheritDepth == Other.InheritDepth &&
+			InheritDesaturation == Other.InheritDesaturation;
+	}
+
+	friend uint32 GetTypeHash(const FColorizedFolderColorScheme& Scheme)
+	{
+		uint32 Hash = HashCombineFast(GetTypeHash(Scheme.FolderNames), GetTypeHash(Scheme.ExplicitPaths));
+		Hash = HashCombineFast(Hash, GetTypeHash(Scheme.SchemeColor));
+		Hash = HashCombineFast(Hash, GetTypeHash(Scheme.bInheritToChildren));
+		Hash = HashCombineFast(Hash, GetTypeHash(Scheme.InheritDepth));
+		return HashCombineFast(Hash, GetTypeHash(Scheme.InheritDesaturation));
 	}
 };
 
@@ -127,6 +172,17 @@ struct FColorizedFolderColorSchemeList
 	FText DisplayNames[NUM_FOLDER_SCHEMES];
 };
 
+/** The theme directory a theme has been loaded from. Later layers override themes with the same id from earlier ones. */
+enum class EColorizedFolderThemeOrigin : uint8
+{
+	/** The built-in fallback theme. */
+	Default,
+	Plugin,
+	Engine,
+	Project,
+	User,
+};
+
 /** Represents a theme of colorized folder schemes. */
 USTRUCT()
 struct FColorizedFolderTheme
@@ -143,6 +199,18 @@ struct FColorizedFolderTheme
 	/** Filename where the theme is stored */
 	FString Filename;
 
+	/** The theme directory Filename is in. New themes are saved to the user directory. */
+	EColorizedFolderThemeOrigin Origin = EColorizedFolderThemeOrigin::User;
+
+	/** Origins of the files this theme overrides, from the first loaded to the last */
+	TArray<EColorizedFolderThemeOrigin> OverriddenOrigins;
+
+	/** Returns true if the theme has been loaded from, or overrides, a theme in the given directory */
+	bool HasOrigin(EColorizedFolderThemeOrigin InOrigin) const
+	{
+		return Origin == InOrigin || OverriddenOrigins.Contains(InOrigin);
+	}
+
 	/** The default color schemes for this theme. Used for resetting to default. Not the active colors. */
 	TArray<FColorizedFolderColorScheme> LoadedDefaultColorSchemes;
 